@@ -0,0 +1,242 @@
+/**
+ * @file bench_ciphers.cpp
+ * @brief Замер скорости функций шифрования
+ *
+ * Для каждого шифра, размера входа, доли букв и длины ключа выводит
+ * нс/байт, ГБ/с и выделения памяти на вызов. С --json пишет те же
+ * результаты в файл для сравнения между коммитами.
+ */
+
+#include "ciphers.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::atomic<uint64_t> allocations{0};
+volatile size_t sink = 0; ///< Не дает компилятору выбросить результат шифрования
+
+/**
+ * @struct Mix
+ * @brief Состав входного текста
+ */
+struct Mix {
+    const char* name;    ///< Название в отчете
+    double letterShare;  ///< Доля букв
+    bool mixedCase;      ///< Использовать заглавные буквы
+};
+
+/**
+ * @struct Kernel
+ * @brief Замеряемая функция с ключом
+ */
+struct Kernel {
+    std::string cipher;  ///< Название шифра
+    std::string key;     ///< Ключ или его длина в отчете
+    std::function<std::string(const std::string&)> encrypt; ///< Шифрование
+};
+
+/**
+ * @struct Result
+ * @brief Результат замера
+ */
+struct Result {
+    std::string cipher;   ///< Шифр
+    std::string key;      ///< Ключ
+    std::string mix;      ///< Состав входа
+    size_t bytes;         ///< Размер входа
+    double nsPerByte;     ///< Наносекунд на байт (лучший повтор)
+    double gbPerSecond;   ///< Гигабайт в секунду (лучший повтор)
+    double allocsPerCall; ///< Выделений памяти на вызов
+    int repeats;          ///< Количество повторов
+};
+
+std::string makeInput(size_t bytes, const Mix& mix) {
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<double> share(0.0, 1.0);
+    std::uniform_int_distribution<int> letter(0, 25);
+    const char others[] = "0123456789 .,!?-";
+    std::uniform_int_distribution<int> other(0, sizeof(others) - 2);
+
+    std::string text(bytes, ' ');
+    for (char& c : text) {
+        if (share(rng) < mix.letterShare) {
+            bool upper = mix.mixedCase && share(rng) < 0.5;
+            c = static_cast<char>((upper ? 'A' : 'a') + letter(rng));
+        } else {
+            c = others[other(rng)];
+        }
+    }
+    return text;
+}
+
+std::string makeKey(size_t length) {
+    std::string key;
+    for (size_t i = 0; i < length; ++i) {
+        key += static_cast<char>('A' + (i * 7 + 3) % 26);
+    }
+    return key;
+}
+
+std::vector<Kernel> kernels() {
+    std::vector<Kernel> list = {
+        {"caesar", "3", [](const std::string& text) { return caesarEncrypt(text, 3); }},
+        {"affine", "5,8", [](const std::string& text) { return affineEncrypt(text, 5, 8); }},
+    };
+    for (size_t length : {3, 6, 16, 64}) {
+        std::string key = makeKey(length);
+        list.push_back({"vigenere", "len" + std::to_string(length),
+                        [key](const std::string& text) { return vigenereEncrypt(text, key); }});
+    }
+    return list;
+}
+
+Result measure(const Kernel& kernel, const Mix& mix, const std::string& input, double minSeconds) {
+    using Clock = std::chrono::steady_clock;
+
+    double best = 1e300;
+    uint64_t allocated = 0;
+    int repeats = 0;
+    Clock::time_point started = Clock::now();
+    // Минимум 3 повтора и не меньше minSeconds в сумме; берется лучший повтор
+    while (repeats < 3 || std::chrono::duration<double>(Clock::now() - started).count() < minSeconds) {
+        uint64_t before = allocations.load(std::memory_order_relaxed);
+        Clock::time_point start = Clock::now();
+        std::string output = kernel.encrypt(input);
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        allocated += allocations.load(std::memory_order_relaxed) - before;
+        sink = sink + output.size();
+
+        best = std::min(best, seconds);
+        ++repeats;
+    }
+
+    Result result;
+    result.cipher = kernel.cipher;
+    result.key = kernel.key;
+    result.mix = mix.name;
+    result.bytes = input.size();
+    result.nsPerByte = best * 1e9 / input.size();
+    result.gbPerSecond = input.size() / best / 1e9;
+    result.allocsPerCall = static_cast<double>(allocated) / repeats;
+    result.repeats = repeats;
+    return result;
+}
+
+void writeJson(const std::string& path, const std::vector<Result>& results) {
+    std::ofstream out(path);
+    out << "[\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << "  {\"cipher\": \"" << r.cipher << "\", \"key\": \"" << r.key << "\", \"mix\": \"" << r.mix
+            << "\", \"bytes\": " << r.bytes << ", \"ns_per_byte\": " << r.nsPerByte
+            << ", \"gb_per_s\": " << r.gbPerSecond << ", \"allocs_per_call\": " << r.allocsPerCall
+            << ", \"repeats\": " << r.repeats << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "]\n";
+    if (!out) {
+        throw std::runtime_error("Failed to write " + path);
+    }
+}
+
+size_t parseSize(const std::string& text) {
+    size_t pos = 0;
+    double value = std::stod(text, &pos);
+    std::string suffix = text.substr(pos);
+    if (suffix == "K") value *= 1024;
+    else if (suffix == "M") value *= 1024 * 1024;
+    else if (suffix == "G") value *= 1024.0 * 1024 * 1024;
+    else if (!suffix.empty()) throw std::invalid_argument("Bad size: " + text);
+    return static_cast<size_t>(value);
+}
+
+}
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+int main(int argc, char* argv[]) {
+    // По умолчанию до 64 МБ: вход в 1 ГБ требует еще 2-3 ГБ памяти на результат
+    size_t maxBytes = 64u << 20;
+    double minSeconds = 0.2;
+    std::string jsonPath;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--max-bytes" && i + 1 < argc) {
+                maxBytes = parseSize(argv[++i]);
+            } else if (arg == "--min-time" && i + 1 < argc) {
+                minSeconds = std::stod(argv[++i]);
+            } else if (arg == "--json" && i + 1 < argc) {
+                jsonPath = argv[++i];
+            } else {
+                std::cerr << "Usage: " << argv[0]
+                          << " [--max-bytes <n>[K|M|G]] [--min-time <seconds>] [--json <file>]" << std::endl;
+                return 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    const Mix mixes[] = {
+        {"letters", 1.0, false},
+        {"mixed-case", 1.0, true},
+        {"half-letters", 0.5, false},
+        {"few-letters", 0.1, false},
+    };
+    const size_t sizes[] = {8, 64, 1u << 10, 64u << 10, 1u << 20, 16u << 20, 256u << 20, 1u << 30};
+
+    std::vector<Result> results;
+    std::printf("%-9s %-6s %-13s %12s %9s %8s %12s\n", "cipher", "key", "mix", "bytes", "ns/byte", "GB/s",
+                "allocs/call");
+    try {
+        for (size_t bytes : sizes) {
+            if (bytes > maxBytes) {
+                break;
+            }
+            for (const Mix& mix : mixes) {
+                std::string input = makeInput(bytes, mix);
+                for (const Kernel& kernel : kernels()) {
+                    Result r = measure(kernel, mix, input, minSeconds);
+                    std::printf("%-9s %-6.6s %-13s %12zu %9.3f %8.3f %12.1f\n", r.cipher.c_str(), r.key.c_str(),
+                                r.mix.c_str(), r.bytes, r.nsPerByte, r.gbPerSecond, r.allocsPerCall);
+                    results.push_back(r);
+                }
+            }
+        }
+
+        if (!jsonPath.empty()) {
+            writeJson(jsonPath, results);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,241 @@
+/**
+ * @file bench_database.cpp
+ * @brief Замер работы Database на больших таблицах слов
+ *
+ * Для таблиц от 1 тыс. до 10 млн слов выводит время открытия базы,
+ * процентили задержки getRandomWord, скорость пакетного чтения
+ * getAllWords и масштабирование параллельных читателей одного образа.
+ * Синтетические базы создаются в --dir и переиспользуются при следующих
+ * запусках.
+ */
+
+#include "database.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const char* TABLE = "caesar_cipher";
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/**
+ * @struct Latency
+ * @brief Процентили задержки запросов в микросекундах
+ */
+struct Latency {
+    size_t samples = 0; ///< Количество запросов
+    double p50 = 0;     ///< Медиана
+    double p95 = 0;     ///< 95-й процентиль
+    double p99 = 0;     ///< 99-й процентиль
+    double max = 0;     ///< Максимум
+};
+
+Latency randomWordLatency(Database& db, size_t maxQueries, double budgetSeconds) {
+    std::vector<double> micros;
+    Clock::time_point started = Clock::now();
+    while (micros.size() < maxQueries && (micros.size() < 20 || secondsSince(started) < budgetSeconds)) {
+        Clock::time_point start = Clock::now();
+        db.getRandomWord(TABLE);
+        micros.push_back(secondsSince(start) * 1e6);
+    }
+
+    std::sort(micros.begin(), micros.end());
+    auto at = [&micros](double fraction) {
+        return micros[static_cast<size_t>(fraction * (micros.size() - 1) + 0.5)];
+    };
+    Latency result;
+    result.samples = micros.size();
+    result.p50 = at(0.50);
+    result.p95 = at(0.95);
+    result.p99 = at(0.99);
+    result.max = micros.back();
+    return result;
+}
+
+bool fileExists(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0;
+}
+
+size_t countWords(Database& db) {
+    return db.getAllWords(TABLE).size();
+}
+
+/**
+ * @brief Создать базу с не менее чем words словами в таблице caesar_cipher
+ */
+void buildDatabase(const std::string& path, size_t words) {
+    Database db(path);
+    std::ostringstream sql;
+    sql << "BEGIN;"
+        << "WITH RECURSIVE seq(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM seq WHERE i < " << words << ") "
+        << "INSERT OR IGNORE INTO " << TABLE << " (word) "
+        << "SELECT printf('w%09d', i) || substr('abcdefghijklmnopqrstuvwxyz', 1 + i % 7, 3 + i % 17) FROM seq;"
+        << "COMMIT;";
+    db.execute(sql.str());
+}
+
+std::string formatCount(size_t words) {
+    if (words >= 1000000) return std::to_string(words / 1000000) + "M";
+    if (words >= 1000) return std::to_string(words / 1000) + "k";
+    return std::to_string(words);
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t maxWords = 1000000;
+    size_t maxQueries = 2000;
+    double budgetSeconds = 2.0;
+    std::string dir = ".";
+    std::string jsonPath;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--max-words" && i + 1 < argc) {
+                maxWords = std::stoul(argv[++i]);
+            } else if (arg == "--queries" && i + 1 < argc) {
+                maxQueries = std::max<size_t>(1, std::stoul(argv[++i]));
+            } else if (arg == "--budget" && i + 1 < argc) {
+                budgetSeconds = std::stod(argv[++i]);
+            } else if (arg == "--dir" && i + 1 < argc) {
+                dir = argv[++i];
+            } else if (arg == "--json" && i + 1 < argc) {
+                jsonPath = argv[++i];
+            } else {
+                std::cerr << "Usage: " << argv[0] << " [--max-words <n>] [--queries <n>] [--budget <seconds>]"
+                          << " [--dir <path>] [--json <file>]" << std::endl;
+                return 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    const size_t sizes[] = {1000, 10000, 100000, 1000000, 10000000};
+    const unsigned readerCounts[] = {1, 2, 4, 8};
+    std::ostringstream json;
+    json << "[";
+    bool firstRow = true;
+    std::printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+
+    try {
+        for (size_t words : sizes) {
+            if (words > maxWords) {
+                break;
+            }
+            std::string path = dir + "/bench_" + formatCount(words) + ".db";
+
+            Clock::time_point start = Clock::now();
+            if (!fileExists(path)) {
+                buildDatabase(path, words);
+            }
+            double buildSeconds = secondsSince(start);
+
+            start = Clock::now();
+            Database disk(path);
+            double openDisk = secondsSince(start);
+
+            start = Clock::now();
+            std::shared_ptr<const DatabaseImage> image = Database::loadImage(path);
+            double loadImage = secondsSince(start);
+
+            start = Clock::now();
+            Database memory(image);
+            double openImage = secondsSince(start);
+
+            start = Clock::now();
+            size_t rows = countWords(memory);
+            double batchSeconds = secondsSince(start);
+
+            Latency diskLatency = randomWordLatency(disk, maxQueries, budgetSeconds);
+            Latency memoryLatency = randomWordLatency(memory, maxQueries, budgetSeconds);
+
+            std::printf("\n%s words (%zu rows, %.1f MB image, setup %.2f s)\n", formatCount(words).c_str(), rows,
+                        image->size() / 1e6, buildSeconds);
+            std::printf("  open: disk %.3f ms, loadImage %.3f ms, open image %.3f ms\n",
+                        openDisk * 1e3, loadImage * 1e3, openImage * 1e3);
+            std::printf("  getAllWords: %.0f words/s\n", rows / batchSeconds);
+            for (const auto& [name, latency] : {std::make_pair("disk", diskLatency),
+                                                std::make_pair("image", memoryLatency)}) {
+                std::printf("  getRandomWord %-5s: p50 %.1f us, p95 %.1f us, p99 %.1f us, max %.1f us (%zu queries)\n",
+                            name, latency.p50, latency.p95, latency.p99, latency.max, latency.samples);
+            }
+
+            json << (firstRow ? "" : ",") << "\n  {\"words\": " << words << ", \"rows\": " << rows
+                 << ", \"image_bytes\": " << image->size()
+                 << ", \"open_disk_ms\": " << openDisk * 1e3 << ", \"load_image_ms\": " << loadImage * 1e3
+                 << ", \"open_image_ms\": " << openImage * 1e3
+                 << ", \"get_all_words_per_s\": " << rows / batchSeconds
+                 << ", \"random_word_disk_us\": {\"p50\": " << diskLatency.p50 << ", \"p95\": " << diskLatency.p95
+                 << ", \"p99\": " << diskLatency.p99 << ", \"max\": " << diskLatency.max << "}"
+                 << ", \"random_word_image_us\": {\"p50\": " << memoryLatency.p50
+                 << ", \"p95\": " << memoryLatency.p95 << ", \"p99\": " << memoryLatency.p99
+                 << ", \"max\": " << memoryLatency.max << "}, \"readers\": [";
+            firstRow = false;
+
+            // Каждый читатель открывает свое соединение поверх общего образа
+            size_t perReader = std::max<size_t>(20, std::min(maxQueries, memoryLatency.samples) / 4);
+            double singleRate = 0;
+            for (unsigned readers : readerCounts) {
+                std::vector<std::unique_ptr<Database>> connections;
+                for (unsigned r = 0; r < readers; ++r) {
+                    connections.push_back(std::make_unique<Database>(image));
+                }
+
+                start = Clock::now();
+                std::vector<std::thread> threads;
+                for (unsigned r = 0; r < readers; ++r) {
+                    // Свой генератор у каждого потока: общий rand() берет глобальную блокировку
+                    threads.emplace_back([&connections, r, perReader] {
+                        std::mt19937 rng(r + 1);
+                        for (size_t q = 0; q < perReader; ++q) {
+                            connections[r]->getRandomWord(TABLE, rng);
+                        }
+                    });
+                }
+                for (std::thread& thread : threads) {
+                    thread.join();
+                }
+                double rate = readers * perReader / secondsSince(start);
+                if (readers == 1) {
+                    singleRate = rate;
+                }
+                std::printf("  %u reader(s): %.0f queries/s (x%.2f)\n", readers, rate, rate / singleRate);
+                json << (readers == 1 ? "" : ", ") << "{\"threads\": " << readers << ", \"queries_per_s\": " << rate
+                     << "}";
+            }
+            json << "]}";
+        }
+        json << "\n]\n";
+
+        if (!jsonPath.empty()) {
+            std::ofstream out(jsonPath);
+            out << json.str();
+            if (!out) {
+                throw std::runtime_error("Failed to write " + jsonPath);
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
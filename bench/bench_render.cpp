@@ -0,0 +1,149 @@
+/**
+ * @file bench_render.cpp
+ * @brief Замер скорости отрисовки каждого экрана без дисплея
+ *
+ * Рисует экраны через GameView в скрытое окно драйвера SDL "dummy"
+ * программным рендерером и выводит кадры в секунду, выделения памяти
+ * и вызовы отрисовки на кадр. Запускается из каталога со шрифтом
+ * NotoSans-Regular.ttf.
+ */
+
+#include "game_view.h"
+#include <SDL2/SDL_ttf.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::atomic<uint64_t> allocations{0};
+
+/**
+ * @struct Scenario
+ * @brief Состояние экрана для замера
+ */
+struct Scenario {
+    std::string name;   ///< Название в отчете
+    GameState state;    ///< Отрисовываемое состояние
+    bool typing;        ///< Менять ввод каждый кадр (перестроение меток)
+};
+
+GameState cipherState(const std::string& ciphertext, bool hints) {
+    GameState state;
+    state.currentCipher = CipherType::VIGENERE;
+    state.encryptedWord = ciphertext;
+    state.decryptedWord = std::string(ciphertext.size(), 'a');
+    state.cipherKey = "CIPHER";
+    state.userInput = "abc";
+    state.showHint1 = hints;
+    state.showHint2 = hints;
+    return state;
+}
+
+std::vector<Scenario> scenarios() {
+    const std::string shortText = "khoor";
+    const std::string longText = "xlmwmwewiuyirgisjjsvxcjmzixlmvxcgliviglevegx"; // 45 символов
+
+    GameState result = cipherState(shortText, false);
+    result.userInput = result.decryptedWord;
+    result.gameWon = true;
+
+    return {
+        {"main menu", GameState(), false},
+        {"cipher short", cipherState(shortText, false), false},
+        {"cipher short + hints", cipherState(shortText, true), false},
+        {"cipher 45 chars", cipherState(longText, false), false},
+        {"cipher 45 chars + hints", cipherState(longText, true), false},
+        {"cipher typing", cipherState(shortText, true), true},
+        {"result", result, false},
+    };
+}
+
+}
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+int main(int argc, char* argv[]) {
+    int frames = 5000;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--frames" && i + 1 < argc) {
+            frames = std::max(1, std::atoi(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--frames <count>]" << std::endl;
+            return 1;
+        }
+    }
+
+    SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+    if (SDL_Init(SDL_INIT_VIDEO) < 0 || TTF_Init() == -1) {
+        std::cerr << "SDL could not initialize! SDL_Error: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+    SDL_Window* window = SDL_CreateWindow("bench_render", 0, 0, 800, 600, SDL_WINDOW_HIDDEN);
+    if (!window) {
+        std::cerr << "Window could not be created! SDL_Error: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+
+    int status = 0;
+    try {
+        GameView view(window, false, true);
+
+        std::printf("%-26s %10s %14s %12s %10s\n", "screen", "fps", "allocs/frame", "draw calls", "vertices");
+        uint64_t revision = 0;
+        for (Scenario& scenario : scenarios()) {
+            ++revision; // новая версия, чтобы метки перестроились под сценарий
+            std::string input(scenario.state.userInput);
+
+            // Прогрев: глифы и метки строятся до начала замера
+            for (int i = 0; i < 100; ++i) {
+                view.render(scenario.state, revision);
+            }
+
+            uint64_t allocationsBefore = allocations.load();
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < frames; ++i) {
+                if (scenario.typing) {
+                    scenario.state.userInput.assign(input, 0, static_cast<size_t>(i) % (input.size() + 1));
+                    ++revision;
+                }
+                view.render(scenario.state, revision);
+            }
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            uint64_t allocated = allocations.load() - allocationsBefore;
+
+            const RenderStats& stats = view.lastFrame();
+            std::printf("%-26s %10.0f %14.2f %12d %10d\n", scenario.name.c_str(), frames / elapsed.count(),
+                        static_cast<double>(allocated) / frames, stats.drawCalls, stats.vertices);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        status = 1;
+    }
+
+    SDL_DestroyWindow(window);
+    TTF_Quit();
+    SDL_Quit();
+    return status;
+}
@@ -0,0 +1,102 @@
+/**
+ * @file async_database.h
+ * @brief Асинхронный доступ к базе данных через отдельный поток ввода-вывода
+ */
+
+#ifndef ASYNC_DATABASE_H
+#define ASYNC_DATABASE_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include "database.h"
+
+/**
+ * @class AsyncDatabase
+ * @brief Фасад над Database с единственным рабочим потоком
+ * 
+ * Рабочий поток владеет соединением и по очереди выполняет запросы.
+ * Вызывающий поток сразу получает std::future и не ждет диска.
+ */
+class AsyncDatabase {
+public:
+    /**
+     * @brief Открыть базу данных в рабочем потоке
+     * @param db_path Путь к файлу базы данных
+     * @param mode Режим открытия
+     * @throw std::runtime_error Если не удалось открыть базу данных
+     */
+    AsyncDatabase(const std::string& db_path, DatabaseMode mode = DatabaseMode::READ_WRITE);
+
+    /**
+     * @brief Выполнить оставшиеся запросы и остановить рабочий поток
+     */
+    ~AsyncDatabase();
+
+    AsyncDatabase(const AsyncDatabase&) = delete;
+    AsyncDatabase& operator=(const AsyncDatabase&) = delete;
+
+    /**
+     * @brief Асинхронно получить случайное слово из таблицы
+     * @param table_name Имя таблицы
+     * @return Будущее слово (исключение Database передается через future)
+     */
+    std::future<std::string> getRandomWordAsync(const std::string& table_name);
+
+    /**
+     * @brief Асинхронно получить готовую головоломку
+     * @param cipherType Тип шифра
+     * @return Будущая головоломка
+     */
+    std::future<Puzzle> getRandomPuzzleAsync(CipherType cipherType);
+
+    /**
+     * @brief Асинхронно выполнить SQL-запросы без результата
+     * @param sql Текст запросов
+     * @return Будущее завершение
+     */
+    std::future<void> executeAsync(const std::string& sql);
+
+    /**
+     * @brief Поставить в очередь произвольную операцию над соединением
+     * @param task Функция, принимающая Database&
+     * @return Будущий результат функции
+     */
+    template <typename Task>
+    auto submit(Task&& task) -> std::future<std::invoke_result_t<Task, Database&>> {
+        using Result = std::invoke_result_t<Task, Database&>;
+        auto job = std::make_shared<std::packaged_task<Result(Database&)>>(std::forward<Task>(task));
+        std::future<Result> result = job->get_future();
+        enqueue([job](Database& db) { (*job)(db); });
+        return result;
+    }
+
+private:
+    std::mutex mutex;                                  ///< Защищает очередь и флаг остановки
+    std::condition_variable wakeup;                    ///< Сигнал рабочему потоку
+    std::deque<std::function<void(Database&)>> queue;  ///< Очередь запросов
+    bool stopping;                                     ///< Флаг остановки рабочего потока
+    std::thread worker;                                ///< Рабочий поток
+
+    /**
+     * @brief Добавить операцию в очередь
+     * @param job Операция над соединением
+     */
+    void enqueue(std::function<void(Database&)> job);
+
+    /**
+     * @brief Цикл рабочего потока
+     * @param db_path Путь к файлу базы данных
+     * @param mode Режим открытия
+     * @param opened Результат открытия базы данных
+     */
+    void workerLoop(std::string db_path, DatabaseMode mode, std::promise<void> opened);
+};
+
+#endif
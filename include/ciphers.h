@@ -19,6 +19,18 @@ enum class CipherType {
     VIGENERE ///< Шифр Виженера
 };
 
+/**
+ * @struct Puzzle
+ * @brief Готовая головоломка: исходное слово, ключ и шифротекст
+ */
+struct Puzzle {
+    CipherType cipher;      ///< Тип шифра
+    std::string plaintext;  ///< Исходное слово (ответ)
+    std::string key;        ///< Ключ в виде для подсказки ("3", "5, 8" или "FOX")
+    std::string ciphertext; ///< Зашифрованное слово
+    int difficulty;         ///< Сложность (1-3), см. puzzleDifficulty
+};
+
 // Общие функции
 
 /**
@@ -29,6 +41,16 @@ enum class CipherType {
  */
 bool isPrime(int a, int b);
 
+/**
+ * @brief Задать начальное значение генератора случайных чисел
+ * 
+ * Все случайные выборы (слова, ключи, головоломки) идут через rand(),
+ * поэтому при одном и том же значении и одной и той же последовательности
+ * запросов получаются одни и те же головоломки.
+ * @param seed Начальное значение
+ */
+void seedRandom(unsigned seed);
+
 /**
  * @brief Генерировать случайное число в диапазоне
  * @param min Минимальное значение
@@ -37,6 +59,37 @@ bool isPrime(int a, int b);
  */
 int randNum(int min, int max);
 
+/**
+ * @brief Получить имя таблицы базы данных со словами для шифра
+ * @param cipherType Тип шифра
+ * @return Имя таблицы ("caesar_cipher", "affine_cipher" или "vigenere_cipher")
+ */
+std::string cipherTableName(CipherType cipherType);
+
+/**
+ * @brief Брать случайные слова из бинарного набора слов вместо SQLite
+ * @param pack_path Путь к файлу, созданному WordPack::build
+ * @throw std::runtime_error Если файл не открывается или поврежден
+ */
+void useWordPack(const std::string& pack_path);
+
+/**
+ * @brief Оценить сложность головоломки по количеству букв в слове
+ * @param plaintext Исходное слово
+ * @return 1 (до 8 букв), 2 (до 20 букв) или 3
+ */
+int puzzleDifficulty(const std::string& plaintext);
+
+/**
+ * @brief Получить готовую головоломку для шифра
+ * 
+ * Если в базе данных есть заранее рассчитанные головоломки (таблица puzzles),
+ * головоломка читается одним запросом, иначе слово выбирается и шифруется на месте.
+ * @param cipherType Тип шифра
+ * @return Головоломка
+ */
+Puzzle generatePuzzle(CipherType cipherType);
+
 // Шифр Цезаря
 
 /**
@@ -99,6 +152,12 @@ std::string vigenereEncrypt(const std::string& text, const std::string& key);
  */
 std::string generateVigenereKey();
 
+/**
+ * @brief Список ключевых слов, из которых выбирает generateVigenereKey
+ * @return Ключевые слова
+ */
+const std::vector<std::string>& vigenereKeys();
+
 /**
  * @brief Расширить ключ до длины текста
  * @param key Ключевое слово
@@ -6,28 +6,91 @@
 #ifndef DATABASE_H
 #define DATABASE_H
 
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <random>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 #include <sqlite3.h>
+#include "ciphers.h"
+
+class Counter;
+class Histogram;
+
+/**
+ * @enum DatabaseMode
+ * @brief Режим открытия базы данных
+ */
+enum class DatabaseMode {
+    READ_WRITE, ///< Работа с файлом на диске (создание таблиц и тестовых данных)
+    IN_MEMORY   ///< Файл читается один раз, запросы обслуживаются из образа в памяти
+};
+
+/**
+ * @brief Образ базы данных в памяти (сериализованный файл SQLite)
+ *
+ * Образ неизменяем и может одновременно использоваться несколькими
+ * экземплярами Database в режиме только для чтения.
+ */
+using DatabaseImage = std::vector<unsigned char>;
 
 /**
  * @class Database
  * @brief Класс для взаимодействия с базой данных SQLite
  * 
- * Обеспечивает подключение к базе данных, создание таблиц и получение случайных слов
+ * Обеспечивает подключение к базе данных, создание таблиц и получение случайных слов.
+ * Каждый выполненный запрос учитывается в metrics() по нормализованному тексту
+ * (литералы заменены на ?): время выполнения aip_sql_seconds, возвращенные
+ * строки aip_sql_rows_total, шаги полного просмотра таблиц
+ * aip_sql_fullscan_steps_total и сортировки aip_sql_sorts_total.
  */
 class Database {
 public:
     /**
      * @brief Конструктор класса Database
      * @param db_path Путь к файлу базы данных
+     * @param mode Режим открытия (по умолчанию работа с файлом на диске)
      * @throw std::runtime_error Если не удалось открыть базу данных
      */
-    Database(const std::string& db_path);
+    Database(const std::string& db_path, DatabaseMode mode = DatabaseMode::READ_WRITE);
+
+    /**
+     * @brief Открыть базу данных только для чтения поверх готового образа в памяти
+     * @param image Образ, полученный из loadImage()
+     * @throw std::runtime_error Если образ пуст или не является базой SQLite
+     */
+    explicit Database(std::shared_ptr<const DatabaseImage> image);
     
     /**
      * @brief Деструктор класса Database
      */
     ~Database();
+
+    Database(const Database&) = delete;
+    Database& operator=(const Database&) = delete;
+    
+    /**
+     * @brief Прочитать файл базы данных в память
+     * 
+     * Файл открывается только для чтения и не изменяется; отсутствующий
+     * файл не создается.
+     * @param db_path Путь к файлу базы данных
+     * @return Неизменяемый образ базы данных
+     * @throw std::runtime_error Если не удалось открыть или сериализовать базу данных
+     */
+    static std::shared_ptr<const DatabaseImage> loadImage(const std::string& db_path);
+
+    /**
+     * @brief Задать порог медленного запроса для всех соединений
+     * 
+     * Запросы дольше порога выводятся в std::cerr вместе с числом строк,
+     * шагов полного просмотра таблиц и сортировок.
+     * @param threshold Порог (0 - не выводить)
+     */
+    static void setSlowQueryThreshold(std::chrono::microseconds threshold);
     
     /**
      * @brief Получить случайное слово из указанной таблицы
@@ -36,9 +99,126 @@ public:
      * @throw std::runtime_error Если таблица пуста или не существует
      */
     std::string getRandomWord(const std::string& table_name);
+
+    /**
+     * @brief Получить случайное слово, выбирая его генератором вызывающего
+     * 
+     * В отличие от getRandomWord(table_name) не обращается к общему rand(),
+     * поэтому потоки с собственными генераторами не ждут друг друга.
+     * @param table_name Имя таблицы
+     * @param rng Генератор, которым выбирается слово
+     * @return Случайное слово из таблицы
+     * @throw std::runtime_error Если таблица пуста или не существует
+     */
+    std::string getRandomWord(const std::string& table_name, std::mt19937& rng);
+
+    /**
+     * @brief Получить все слова из указанной таблицы в порядке id
+     * @param table_name Имя таблицы
+     * @return Список слов
+     * @throw std::runtime_error Если таблица не существует
+     */
+    std::vector<std::string> getAllWords(const std::string& table_name);
+
+    /**
+     * @brief Выполнить один или несколько SQL-запросов без результата
+     * 
+     * В запросах доступны функции шифрования caesar(text, key),
+     * affine(text, a, b) и vigenere(text, key), например:
+     * INSERT INTO puzzles SELECT word, caesar(word, 3) FROM caesar_cipher;
+     * @param sql Текст запросов
+     * @throw std::runtime_error Если выполнение завершилось ошибкой
+     */
+    void execute(const std::string& sql);
+
+    /**
+     * @brief Заново заполнить таблицу puzzles готовыми головоломками
+     * 
+     * Для каждого слова создаются головоломки со всеми ключами шифра
+     * (25 для Цезаря, 312 для аффинного, список vigenereKeys() для Виженера).
+     * Шифрование выполняется внутри SQLite одним запросом на шифр.
+     * @throw std::runtime_error Если база открыта только для чтения или запрос не выполнен
+     */
+    void buildPuzzles();
+
+    /**
+     * @brief Проверить, есть ли готовые головоломки для шифра
+     * @param cipherType Тип шифра
+     * @return true если таблица puzzles содержит головоломки этого шифра
+     */
+    bool hasPuzzles(CipherType cipherType);
+
+    /**
+     * @brief Получить случайную готовую головоломку индексным поиском
+     * @param cipherType Тип шифра
+     * @return Головоломка
+     * @throw std::runtime_error Если готовых головоломок нет
+     */
+    Puzzle getRandomPuzzle(CipherType cipherType);
     
 private:
     sqlite3* db; ///< Указатель на соединение с базой данных SQLite
+    std::shared_ptr<const DatabaseImage> image; ///< Образ в памяти (только в режиме IN_MEMORY)
+
+    /**
+     * @struct IdRange
+     * @brief Диапазон id строк таблицы
+     */
+    struct IdRange {
+        bool known = false;     ///< Диапазон уже прочитан из базы
+        sqlite3_int64 first = 0; ///< Минимальный id
+        sqlite3_int64 last = -1; ///< Максимальный id (меньше first, если строк нет)
+    };
+    IdRange puzzleRanges[3]; ///< Кэш диапазонов головоломок по значению CipherType
+    std::unordered_map<std::string, IdRange> wordRanges; ///< Кэш диапазонов rowid таблиц слов (сбрасывается в execute)
+
+    /**
+     * @struct QueryMetrics
+     * @brief Метрики нормализованного запроса в metrics()
+     */
+    struct QueryMetrics {
+        std::string sql;        ///< Нормализованный текст
+        Histogram* seconds;     ///< Время выполнения
+        Counter* rows;          ///< Возвращенные строки
+        Counter* fullScanSteps; ///< Шаги полного просмотра таблиц
+        Counter* sorts;         ///< Сортировки
+    };
+    std::unordered_map<std::string, QueryMetrics> queryMetrics; ///< Кэш метрик по исходному тексту запроса
+
+    /**
+     * @struct RunningQuery
+     * @brief Выполняющийся запрос
+     */
+    struct RunningQuery {
+        sqlite3_stmt* stmt;                           ///< Запрос
+        std::chrono::steady_clock::time_point start; ///< Начало выполнения
+        uint64_t rows;                                ///< Возвращенные строки
+    };
+    std::vector<RunningQuery> runningQueries; ///< Начатые и еще не завершенные запросы
+
+    /**
+     * @brief Получить (и закэшировать) диапазон id головоломок шифра
+     * @param cipherType Тип шифра
+     * @return Диапазон id
+     */
+    const IdRange& puzzleRange(CipherType cipherType);
+
+    /**
+     * @brief Получить (и закэшировать) диапазон rowid таблицы слов
+     * @param table_name Имя таблицы
+     * @return Диапазон rowid
+     */
+    const IdRange& wordRange(const std::string& table_name);
+
+    /**
+     * @brief Выбрать слово поиском по rowid
+     * @param table_name Имя таблицы
+     * @param offset Возвращает случайное смещение от 0 до span - 1 от начала диапазона rowid
+     * @return Слово со случайным rowid (пропуски в rowid на выбор не влияют)
+     * @throw std::runtime_error Если таблица пуста или не существует
+     */
+    std::string selectWord(const std::string& table_name,
+                           const std::function<sqlite3_int64(sqlite3_int64 span)>& offset);
     
     /**
      * @brief Проверить код ошибки SQLite
@@ -47,6 +227,38 @@ private:
      * @throw std::runtime_error Если код ошибки не SQLITE_OK
      */
     void checkError(int rc, const char* error_msg);
+
+    /**
+     * @brief Открыть файл на диске, создать таблицы и тестовые данные
+     * @param db_path Путь к файлу базы данных
+     */
+    void openFile(const std::string& db_path);
+
+    /**
+     * @brief Подключить образ в памяти как основную базу (только чтение)
+     */
+    void attachImage();
+
+    /**
+     * @brief Зарегистрировать функции шифрования как детерминированные SQL-функции
+     */
+    void registerCipherFunctions();
+
+    /**
+     * @brief Подключить учет запросов через sqlite3_trace_v2
+     */
+    void installProfiler();
+
+    /**
+     * @brief Обработчик sqlite3_trace_v2 (SQLITE_TRACE_STMT, SQLITE_TRACE_ROW и SQLITE_TRACE_PROFILE)
+     */
+    static int profileCallback(unsigned type, void* context, void* p, void* x);
+
+    /**
+     * @brief Учесть завершенный запрос
+     * @param stmt Запрос
+     */
+    void queryFinished(sqlite3_stmt* stmt);
     
     /**
      * @brief Заполнить базу данных тестовыми значениями, если таблицы пусты
@@ -54,4 +266,4 @@ private:
     void fillTestDataIfEmpty();
 };
 
-#endif
\ No newline at end of file
+#endif
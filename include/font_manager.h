@@ -0,0 +1,85 @@
+/**
+ * @file font_manager.h
+ * @brief Кэш загруженных шрифтов
+ */
+
+#ifndef FONT_MANAGER_H
+#define FONT_MANAGER_H
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @struct FontStats
+ * @brief Статистика загрузки шрифтов
+ */
+struct FontStats {
+    int filesRead = 0;         ///< Сколько раз файл шрифта читался с диска
+    size_t bytesInMemory = 0;  ///< Размер файлов шрифтов, хранимых в памяти
+    int fontsOpened = 0;       ///< Сколько пар (путь, размер) было открыто
+    int cacheHits = 0;         ///< Сколько запросов обслужено из кэша
+    double loadMilliseconds = 0; ///< Суммарное время чтения файлов и открытия шрифтов
+};
+
+/**
+ * @class FontManager
+ * @brief Загружает каждую пару (путь, размер) один раз
+ * 
+ * В режиме хранения файлов в памяти файл шрифта читается с диска один раз,
+ * и все размеры открываются из общего буфера через TTF_OpenFontRW.
+ * Шрифты закрываются в деструкторе, поэтому менеджер должен быть
+ * уничтожен до TTF_Quit().
+ *
+ * Статистика загрузки, кроме stats(), публикуется в metrics() как
+ * aip_font_* и попадает в --metrics-file.
+ */
+class FontManager {
+public:
+    /**
+     * @brief Конструктор
+     * @param keepFilesInMemory Хранить байты файлов шрифтов в памяти
+     */
+    explicit FontManager(bool keepFilesInMemory = true);
+
+    /**
+     * @brief Деструктор, закрывает все шрифты
+     */
+    ~FontManager();
+
+    FontManager(const FontManager&) = delete;
+    FontManager& operator=(const FontManager&) = delete;
+
+    /**
+     * @brief Получить шрифт заданного размера
+     * @param path Путь к файлу шрифта
+     * @param size Размер в пунктах
+     * @return Шрифт или nullptr при ошибке (подробности в TTF_GetError())
+     */
+    TTF_Font* get(const std::string& path, int size);
+
+    /**
+     * @brief Статистика загрузки
+     * @return Статистика
+     */
+    const FontStats& stats() const;
+
+private:
+    bool keepFilesInMemory; ///< Открывать шрифты из буфера в памяти
+    std::map<std::string, std::vector<char>> files; ///< Байты файлов шрифтов
+    std::map<std::pair<std::string, int>, TTF_Font*> fonts; ///< Открытые шрифты
+    FontStats statistics; ///< Статистика загрузки
+
+    /**
+     * @brief Открыть шрифт, читая файл не больше одного раза
+     * @param path Путь к файлу шрифта
+     * @param size Размер в пунктах
+     * @return Шрифт или nullptr
+     */
+    TTF_Font* open(const std::string& path, int size);
+};
+
+#endif
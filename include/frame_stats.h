@@ -0,0 +1,116 @@
+/**
+ * @file frame_stats.h
+ * @brief Статистика времени кадров
+ */
+
+#ifndef FRAME_STATS_H
+#define FRAME_STATS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @enum FrameStage
+ * @brief Этапы, время которых учитывается отдельно
+ */
+enum class FrameStage {
+    EVENTS,   ///< Обработка событий ввода (включая ожидание базы данных)
+    RENDER,   ///< Построение и вывод кадра
+    DATABASE, ///< Получение головоломок
+    COUNT     ///< Количество этапов
+};
+
+/**
+ * @struct FrameSample
+ * @brief Измерения одного кадра
+ */
+struct FrameSample {
+    double frameMs = 0;    ///< Время работы над кадром: от начала построения до вывода
+    double intervalMs = 0; ///< Время от вывода предыдущего кадра до вывода этого (включая простой)
+    std::array<double, static_cast<size_t>(FrameStage::COUNT)> stageMs{}; ///< Время этапов с прошлого кадра
+    int drawCalls = 0;         ///< Вызовы SDL_RenderGeometry
+    int vertices = 0;          ///< Отправленные вершины
+    int texturesCreated = 0;   ///< Созданные текстуры
+    int texturesDestroyed = 0; ///< Уничтоженные текстуры
+    int textureUploads = 0;    ///< Загрузки пикселей в текстуры
+    uint64_t allocations = 0;    ///< Выделения памяти с прошлого кадра (сборка с AIP_MEMORY_TRACKING)
+    uint64_t allocatedBytes = 0; ///< Выделенные байты с прошлого кадра
+};
+
+/**
+ * @struct FrameSummary
+ * @brief Сводка по последним кадрам
+ */
+struct FrameSummary {
+    size_t frames = 0;   ///< Количество кадров в окне
+    double fps = 0;      ///< Кадров в секунду (по промежуткам между выводами)
+    double p50Ms = 0;    ///< Медиана времени кадра
+    double p95Ms = 0;    ///< 95-й процентиль времени кадра
+    double p99Ms = 0;    ///< 99-й процентиль времени кадра
+    double maxMs = 0;    ///< Максимальное время кадра
+    std::array<double, static_cast<size_t>(FrameStage::COUNT)> stageMs{}; ///< Среднее время этапов на кадр
+    double drawCalls = 0;      ///< Среднее количество вызовов отрисовки на кадр
+    double vertices = 0;       ///< Среднее количество вершин на кадр
+    double texturesCreated = 0;   ///< Среднее количество созданных текстур на кадр
+    double texturesDestroyed = 0; ///< Среднее количество уничтоженных текстур на кадр
+    double textureUploads = 0;    ///< Среднее количество загрузок в текстуры на кадр
+    double allocations = 0;    ///< Среднее количество выделений памяти на кадр
+    double allocatedBytes = 0; ///< Среднее количество выделенных байт на кадр
+};
+
+/**
+ * @class FrameStats
+ * @brief Скользящее окно измерений последних кадров
+ *
+ * Не зависит от SDL: время измеряет вызывающий код. Не потокобезопасен,
+ * все методы вызываются из потока отрисовки.
+ */
+class FrameStats {
+public:
+    /**
+     * @brief Конструктор
+     * @param capacity Количество хранимых кадров
+     */
+    explicit FrameStats(size_t capacity = 300);
+
+    /**
+     * @brief Добавить измерения кадра, вытеснив самый старый
+     * @param sample Измерения
+     */
+    void addFrame(const FrameSample& sample);
+
+    /**
+     * @brief Посчитать сводку по хранимым кадрам
+     * @return Сводка
+     */
+    FrameSummary summary() const;
+
+    /**
+     * @brief Строки для вывода поверх игры
+     * @return Строки текста
+     */
+    std::vector<std::string> overlayLines() const;
+
+    /**
+     * @brief Сводка в формате JSON
+     * @return Объект JSON
+     */
+    std::string toJson() const;
+
+private:
+    std::vector<FrameSample> samples; ///< Кольцевой буфер кадров
+    size_t nextIndex;                 ///< Куда будет записан следующий кадр
+    size_t count;                     ///< Количество записанных кадров (не больше емкости)
+};
+
+/**
+ * @brief Название этапа
+ * @param stage Этап
+ * @return "events", "render" или "database"
+ */
+const char* frameStageName(FrameStage stage);
+
+#endif
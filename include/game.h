@@ -8,14 +8,52 @@
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
 #include <string>
-#include "ciphers.h"
+#include <thread>
+#include "frame_stats.h"
+#include "game_core.h"
+#include "game_view.h"
+#include "input_record.h"
+#include "latency_tracker.h"
+#include "memory_tracking.h"
+#include "metrics.h"
+#include "puzzle_prefetcher.h"
+#include "triple_buffer.h"
+
+/**
+ * @struct GameOptions
+ * @brief Параметры запуска игры
+ */
+struct GameOptions {
+    bool eventDriven = false;   ///< Ждать событий в SDL_WaitEventTimeout и перерисовывать только после изменений
+    bool vsync = false;         ///< Синхронизировать вывод кадра с обновлением экрана
+    int animationIntervalMs = 0; ///< Период принудительной перерисовки в событийном режиме (0 - нет)
+    bool renderThread = false;  ///< Отрисовывать в отдельном потоке, чтобы вывод кадра не задерживал ввод (не на macOS)
+    std::string statsFile;      ///< Файл, куда при выходе записывается статистика кадров в JSON (пусто - нет)
+    std::string latencyFile;    ///< Файл, в конец которого при выходе дописывается строка JSON с задержкой ввода (пусто - нет)
+    std::string recordFile;     ///< Файл, куда записываются события ввода и начальное значение генератора (пусто - нет)
+    uint32_t randomSeed = 0;    ///< Начальное значение генератора при записи (0 - по текущему времени)
+    std::string replayFile;     ///< Воспроизвести записанный ввод вместо ввода игрока (пусто - нет)
+    bool replayFast = false;    ///< Воспроизводить без пауз между событиями
+    bool headless = false;      ///< Без дисплея: драйвер SDL "dummy" и программный рендерер
+    std::string traceFile;      ///< Файл трассы Chrome: пишется по F4 и при выходе (пусто - нет, нужна сборка с AIP_TRACING)
+    std::string metricsFile;    ///< Файл метрик для агента мониторинга: Prometheus или JSON для *.json (пусто - нет)
+    int metricsIntervalMs = 10000; ///< Период перезаписи файла метрик
+    std::string memoryFile;     ///< Файл, куда при выходе записывается память по подсистемам в JSON (пусто - нет, нужна сборка с AIP_MEMORY_TRACKING)
+};
 
 /**
  * @class Game
- * @brief Основной класс игры, управляющий логикой и отображением
+ * @brief SDL интерфейс игры
  * 
- * Обрабатывает ввод пользователя, отображает интерфейс и управляет игровым процессом
+ * Передает ввод пользователя в GameCore и отображает его состояние
  */
 class Game {
 public:
@@ -23,8 +61,10 @@ public:
      * @brief Конструктор класса Game
      * 
      * Инициализирует SDL, создает окно и загружает шрифты
+     * @param options Параметры запуска
+     * @throw std::runtime_error Если запись ввода, SDL, окно или шрифты не открываются
      */
-    Game();
+    explicit Game(const GameOptions& options = GameOptions());
     
     /**
      * @brief Деструктор класса Game
@@ -35,31 +75,49 @@ public:
     
     /**
      * @brief Основной игровой цикл
+     * @throw std::runtime_error Если поток отрисовки не смог создать рендерер
      */
     void run();
 
 private:
+    GameOptions options;   ///< Параметры запуска
     SDL_Window* window;    ///< Указатель на SDL окно
-    SDL_Renderer* renderer;///< Указатель на SDL рендерер
-    TTF_Font* font;        ///< Указатель на загруженный шрифт
+    std::unique_ptr<GameView> view; ///< Отрисовка (живет в потоке, который ее создал)
+    std::unique_ptr<PuzzlePrefetcher> prefetcher; ///< Готовые головоломки, чтобы клик по кнопке не ждал базу данных
+    GameCore core;         ///< Логика игры
+    uint64_t drawnRevision;  ///< Версия состояния, показанная на экране
+    bool needsRedraw;      ///< Кадр на экране устарел независимо от состояния (например, окно перекрыто)
     
     bool running;          ///< Флаг работы основного цикла
-    CipherType currentCipher; ///< Текущий выбранный шифр
-    
-    // Состояние игры
-    std::string encryptedWord; ///< Зашифрованное слово
-    std::string decryptedWord; ///< Расшифрованное слово (ответ)
-    std::string userInput;     ///< Ввод пользователя
-    std::string cipherKey;     ///< Ключ шифрования
-    bool showHint1;           ///< Флаг показа первой подсказки
-    bool showHint2;           ///< Флаг показа второй подсказки
-    bool gameWon;             ///< Флаг победы в текущем раунде
+
+    TripleBuffer<GameSnapshot> snapshots; ///< Снимки состояния для потока отрисовки
+    uint64_t publishedRevision;           ///< Версия последнего опубликованного снимка
+    std::thread renderThread;             ///< Поток отрисовки
+    std::mutex renderMutex;               ///< Защищает renderSignal и stopRendering
+    std::condition_variable renderWake;   ///< Будит поток отрисовки
+    bool renderSignal;                    ///< Есть новый снимок или нужна перерисовка
+    bool stopRendering;                   ///< Поток отрисовки должен завершиться
+    std::exception_ptr renderError;       ///< Ошибка создания отрисовки в ее потоке (читается после join)
+
+    FrameStats frameStats;                ///< Статистика кадров (только поток отрисовки)
+    std::array<std::atomic<Uint64>, static_cast<size_t>(FrameStage::COUNT)> stageTicks; ///< Время этапов с прошлого кадра в тиках SDL_GetPerformanceCounter
+    Uint64 lastPresent;                   ///< Момент вывода прошлого кадра
+    Uint32 overlayUpdated;                ///< Когда обновлялся текст статистики на экране
+    std::atomic<bool> showStats;          ///< Показывать статистику поверх игры (F3)
+    LatencyTracker latency;               ///< Задержка от клавиатурного ввода до кадра
+    MemoryUsage framedMemory;             ///< Счетчики памяти на момент прошлого кадра
+
+    std::unique_ptr<InputRecorder> recorder; ///< Запись ввода (если включена)
+    Uint32 recordStart;                   ///< Метка времени SDL начала записи
+    InputRecording replayInput;           ///< Воспроизводимый ввод
+    std::unique_ptr<MetricsWriter> metricsWriter; ///< Периодическая запись метрик (если включена)
 
     /**
      * @brief Инициализировать SDL и создать окно
+     * @throw std::runtime_error Если SDL, окно или отрисовка не создаются
      */
     void initSDL();
-    
+
     /**
      * @brief Освободить ресурсы SDL
      */
@@ -71,36 +129,96 @@ private:
     void render();
     
     /**
-     * @brief Обработать события ввода
+     * @brief Обработать все накопившиеся события ввода
      */
     void handleEvents();
-    
+
     /**
-     * @brief Показать главное меню
+     * @brief Обработать одно событие
+     * @param e Событие SDL
      */
-    void showMainMenu();
-    
+    void handleEvent(const SDL_Event& e);
+
     /**
-     * @brief Показать экран с выбранным шифром
-     * @param cipherType Тип шифра (CAESAR, AFFINE или VIGENERE)
+     * @brief Выполнить действие события (без учета времени)
+     * @param e Событие SDL
      */
-    void showCipherScreen(CipherType cipherType);
-    
+    void dispatchEvent(const SDL_Event& e);
+
     /**
-     * @brief Отрисовать экран с шифром
+     * @brief Игровой цикл с постоянной перерисовкой
      */
-    void renderCipherScreen();
-    
+    void runPolling();
+
     /**
-     * @brief Проверить ответ пользователя
+     * @brief Игровой цикл, ожидающий событий и перерисовывающий только изменения
      */
-    void checkAnswer();
-    
+    void runEventDriven();
+
+    /**
+     * @brief Игровой цикл, в котором кадры выводит отдельный поток
+     * 
+     * Основной поток только обрабатывает ввод и публикует снимки состояния;
+     * медленная отрисовка или vsync не задерживают реакцию на ввод. На macOS
+     * режим недоступен: SDL с Cocoa работает с окном только из главного потока.
+     */
+    void runThreaded();
+
+    /**
+     * @brief Подать записанный ввод через handleEvent
+     * 
+     * Кадры выводятся после каждого события, изменившего состояние, как в событийном цикле.
+     */
+    void runReplay();
+
+    /**
+     * @brief Задать начальное значение генератора, открыть запись или загрузить воспроизводимый ввод
+     * 
+     * Вызывается до запуска фоновой подготовки головоломок, чтобы все они
+     * были созданы после seedRandom.
+     */
+    void initInputRecording();
+
+    /**
+     * @brief Тело потока отрисовки
+     */
+    void renderLoop();
+
+    /**
+     * @brief Остановить поток отрисовки и дождаться его завершения
+     */
+    void stopRenderThread();
+
+    /**
+     * @brief Опубликовать снимок состояния, если оно изменилось или нужна перерисовка
+     */
+    void publishState();
+
+    /**
+     * @brief Вывести кадр и записать его измерения
+     * 
+     * Вызывается в потоке, владеющем view.
+     * @param state Состояние игры
+     * @param revision Версия состояния
+     */
+    void drawFrame(const GameState& state, uint64_t revision);
+
+    /**
+     * @brief Записать трассу в options.traceFile, если он задан
+     */
+    void writeTrace() const;
+
+    /**
+     * @brief Добавить время этапа к текущему кадру
+     * @param stage Этап
+     * @param start Значение SDL_GetPerformanceCounter в начале этапа
+     */
+    void addStageTime(FrameStage stage, Uint64 start);
+
     /**
-     * @brief Показать результат (победа/поражение)
-     * @param correct Флаг правильного ответа
+     * @brief Записать статистику кадров в options.statsFile и задержку ввода в options.latencyFile
      */
-    void showResult(bool correct);
+    void writeStats() const;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,145 @@
+/**
+ * @file game_core.h
+ * @brief Логика игры без зависимости от SDL
+ */
+
+#ifndef GAME_CORE_H
+#define GAME_CORE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include "ciphers.h"
+#include "ui_layout.h"
+
+/**
+ * @struct GameState
+ * @brief Состояние игры, которое отображает внешний интерфейс
+ *
+ * Строки берут память из переданного ресурса; копия состояния (например,
+ * снимок для потока отрисовки) всегда использует обычную кучу.
+ */
+struct GameState {
+    CipherType currentCipher = CipherType::CAESAR; ///< Текущий выбранный шифр
+    std::pmr::string encryptedWord; ///< Зашифрованное слово
+    std::pmr::string decryptedWord; ///< Расшифрованное слово (ответ)
+    std::pmr::string userInput;     ///< Ввод пользователя
+    std::pmr::string cipherKey;     ///< Ключ шифрования
+    bool showHint1 = false;    ///< Флаг показа первой подсказки
+    bool showHint2 = false;    ///< Флаг показа второй подсказки
+    bool gameWon = false;      ///< Флаг победы в текущем раунде
+
+    GameState() = default;
+
+    /**
+     * @brief Конструктор
+     * @param resource Ресурс памяти строк
+     */
+    explicit GameState(std::pmr::memory_resource* resource);
+
+    /**
+     * @brief Определить текущий экран
+     * @return Экран
+     */
+    Screen screen() const;
+};
+
+/**
+ * @brief Источник головоломок для новых раундов
+ */
+using PuzzleSource = std::function<Puzzle(CipherType)>;
+
+/**
+ * @class GameCore
+ * @brief Машина состояний раундов игры
+ * 
+ * Не использует SDL, поэтому раунды можно моделировать без окна:
+ * в тестах, ботах и на сервере сборки. Строки раунда живут в арене,
+ * которая целиком освобождается при переходе к следующему раунду или в
+ * меню, поэтому ввод внутри раунда не обращается к куче.
+ */
+class GameCore {
+public:
+    /**
+     * @brief Конструктор
+     * @param source Источник головоломок (по умолчанию generatePuzzle)
+     */
+    explicit GameCore(PuzzleSource source = generatePuzzle);
+
+    GameCore(const GameCore&) = delete;
+    GameCore& operator=(const GameCore&) = delete;
+
+    /**
+     * @brief Текущее состояние
+     * @return Состояние игры
+     */
+    const GameState& state() const;
+
+    /**
+     * @brief Номер версии состояния, увеличивается при каждом изменении
+     * @return Номер версии
+     */
+    uint64_t revision() const;
+
+    /**
+     * @brief Начать раунд с выбранным шифром
+     * @param cipherType Тип шифра (CAESAR, AFFINE или VIGENERE)
+     */
+    void showCipherScreen(CipherType cipherType);
+
+    /**
+     * @brief Вернуться в главное меню
+     */
+    void showMainMenu();
+
+    /**
+     * @brief Добавить введенный текст к ответу
+     * @param text Текст
+     */
+    void typeText(std::string_view text);
+
+    /**
+     * @brief Удалить последний символ ответа
+     */
+    void backspace();
+
+    /**
+     * @brief Проверить ответ пользователя
+     */
+    void checkAnswer();
+
+    /**
+     * @brief Выполнить действие кнопки
+     * @param id Идентификатор кнопки
+     */
+    void pressWidget(WidgetId id);
+
+    /**
+     * @brief Обработать нажатие мыши в координатах окна
+     * @param x Координата x
+     * @param y Координата y
+     * @return true если нажатие попало в кнопку текущего экрана
+     */
+    bool click(int x, int y);
+
+private:
+    /// Размер встроенного буфера арены раунда; длинные строки берут остальное из кучи
+    static constexpr size_t ROUND_ARENA_SIZE = 1024;
+
+    PuzzleSource source; ///< Источник головоломок
+    std::array<std::byte, ROUND_ARENA_SIZE> roundBuffer; ///< Встроенная память арены раунда
+    std::pmr::monotonic_buffer_resource roundArena;      ///< Арена строк текущего раунда
+    GameState current;   ///< Состояние (строки в roundArena)
+    uint64_t version;    ///< Номер версии состояния
+
+    /**
+     * @brief Очистить состояние раунда и освободить его арену
+     */
+    void resetRound();
+};
+
+#endif
@@ -0,0 +1,154 @@
+/**
+ * @file game_view.h
+ * @brief Отрисовка состояния игры
+ */
+
+#ifndef GAME_VIEW_H
+#define GAME_VIEW_H
+
+#include <SDL2/SDL.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+#include "font_manager.h"
+#include "game_core.h"
+#include "label.h"
+#include "render_batch.h"
+#include "text_renderer.h"
+#include "ui_layout.h"
+
+/**
+ * @struct GameSnapshot
+ * @brief Неизменяемый снимок состояния, передаваемый в поток отрисовки
+ */
+struct GameSnapshot {
+    GameState state;       ///< Состояние игры
+    uint64_t revision = 0; ///< Версия состояния
+};
+
+/**
+ * @class GameView
+ * @brief Рендерер, шрифты и метки окна игры
+ *
+ * Все методы, включая конструктор и деструктор, должны вызываться из одного
+ * потока: SDL требует работать с рендерером в потоке, который его создал.
+ */
+class GameView {
+public:
+    /**
+     * @brief Конструктор
+     *
+     * Создает рендерер для окна и загружает шрифты
+     * @param window Окно SDL
+     * @param vsync Синхронизировать вывод кадра с обновлением экрана
+     * @param software Использовать программный рендерер (без видеокарты)
+     * @throw std::runtime_error Если рендерер или шрифты не создаются
+     */
+    GameView(SDL_Window* window, bool vsync, bool software = false);
+
+    /**
+     * @brief Деструктор
+     *
+     * Освобождает текстуры, шрифты и рендерер
+     */
+    ~GameView();
+
+    GameView(const GameView&) = delete;
+    GameView& operator=(const GameView&) = delete;
+
+    /**
+     * @brief Отрисовать и вывести кадр
+     * @param state Состояние игры
+     * @param revision Версия состояния; тексты меток перестраиваются только при ее изменении
+     */
+    void render(const GameState& state, uint64_t revision);
+
+    /**
+     * @brief Задать строки, выводимые поверх игры в левом верхнем углу
+     * @param lines Строки текста (пустой список скрывает вывод)
+     */
+    void setOverlay(const std::vector<std::string>& lines);
+
+    /**
+     * @brief Статистика вывода последнего кадра
+     * @return Статистика
+     */
+    const RenderStats& lastFrame() const;
+
+private:
+    /**
+     * @enum LabelSlot
+     * @brief Текстовые метки интерфейса
+     */
+    enum class LabelSlot {
+        TITLE, SUBTITLE, CIPHER_NAME, ENCRYPTED, INPUT, HINT1, HINT2, RESULT, DECRYPTED, KEY,
+        COUNT ///< Количество меток
+    };
+
+    SDL_Renderer* renderer;                  ///< Указатель на SDL рендерер
+    std::unique_ptr<FontManager> fonts;      ///< Кэш загруженных шрифтов
+    std::unique_ptr<TextRenderer> text;      ///< Атлас глифов основного шрифта
+    std::unique_ptr<TextRenderer> titleText; ///< Атлас глифов шрифта заголовка
+    std::array<std::unique_ptr<Label>, static_cast<size_t>(LabelSlot::COUNT)> labels; ///< Метки интерфейса
+    std::array<std::unique_ptr<Label>, static_cast<size_t>(WidgetId::COUNT)> widgetLabels; ///< Подписи виджетов
+    std::vector<std::unique_ptr<Label>> overlayLabels; ///< Строки вывода поверх игры
+    size_t overlayLines;                     ///< Сколько строк overlayLabels сейчас выводится
+    std::unique_ptr<RenderBatch> batch;      ///< Пакет геометрии кадра
+    uint64_t labelsRevision;                 ///< Версия состояния, по которой построены тексты меток
+    std::array<std::byte, 1024> scratchBuffer;         ///< Встроенная память временных строк кадра
+    std::pmr::monotonic_buffer_resource frameScratch;  ///< Временные строки кадра, освобождаются в конце render()
+
+    /**
+     * @brief Создать метки и задать их неизменные тексты и положения
+     */
+    void initLabels();
+
+    /**
+     * @brief Обновить тексты меток, зависящие от состояния игры
+     *
+     * Геометрия перестраивается лишь у меток, текст которых действительно изменился.
+     * Составные тексты собираются в frameScratch.
+     * @param state Состояние игры
+     */
+    void updateLabels(const GameState& state);
+
+    /**
+     * @brief Получить метку
+     * @param slot Идентификатор метки
+     * @return Метка
+     */
+    Label& label(LabelSlot slot);
+
+    /**
+     * @brief Отрисовать виджеты экрана из его раскладки
+     * @param screen Экран
+     */
+    void renderWidgets(Screen screen);
+
+    /**
+     * @brief Показать главное меню
+     */
+    void showMainMenu();
+
+    /**
+     * @brief Отрисовать экран с шифром
+     * @param state Состояние игры
+     */
+    void renderCipherScreen(const GameState& state);
+
+    /**
+     * @brief Показать результат раунда
+     */
+    void showResult();
+
+    /**
+     * @brief Отрисовать строки поверх игры
+     */
+    void renderOverlay();
+};
+
+#endif
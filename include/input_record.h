@@ -0,0 +1,111 @@
+/**
+ * @file input_record.h
+ * @brief Запись и воспроизведение ввода игрока
+ *
+ * Формат файла (числа записываются побайтно в порядке little-endian на
+ * любой машине, поэтому запись переносима между архитектурами):
+ * - InputRecordHeader (поля подряд, без выравнивания);
+ * - события до конца файла: uint32_t время в мс от начала записи,
+ *   uint8_t RecordedEventType и данные события:
+ *   KEY_DOWN и WINDOW - int32_t код, MOUSE_DOWN - int32_t x и int32_t y,
+ *   TEXT_INPUT - uint8_t длина и байты текста в UTF-8, QUIT - ничего.
+ */
+
+#ifndef INPUT_RECORD_H
+#define INPUT_RECORD_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/// Сигнатура файла записи ввода
+constexpr char INPUT_RECORD_MAGIC[4] = {'A', 'I', 'P', 'R'};
+
+/// Текущая версия формата
+constexpr uint32_t INPUT_RECORD_VERSION = 1;
+
+/**
+ * @struct InputRecordHeader
+ * @brief Заголовок файла записи ввода
+ */
+struct InputRecordHeader {
+    char magic[4];     ///< Сигнатура INPUT_RECORD_MAGIC
+    uint32_t version;  ///< Версия формата
+    uint32_t seed;     ///< Начальное значение seedRandom на время записи
+    uint32_t reserved; ///< Зарезервировано (0)
+};
+
+static_assert(sizeof(InputRecordHeader) == 16, "InputRecordHeader layout");
+
+/**
+ * @enum RecordedEventType
+ * @brief Типы записываемых событий
+ */
+enum class RecordedEventType : uint8_t {
+    QUIT,       ///< Закрытие окна
+    KEY_DOWN,   ///< Нажатие клавиши
+    TEXT_INPUT, ///< Ввод текста
+    MOUSE_DOWN, ///< Нажатие кнопки мыши
+    WINDOW      ///< Событие окна (перекрытие, изменение размера)
+};
+
+/**
+ * @struct RecordedEvent
+ * @brief Событие ввода без зависимости от SDL
+ */
+struct RecordedEvent {
+    uint32_t timeMs = 0;                             ///< Время от начала записи
+    RecordedEventType type = RecordedEventType::QUIT; ///< Тип события
+    int32_t code = 0;                                ///< Код клавиши или события окна
+    int32_t x = 0;                                   ///< Координата x нажатия мыши
+    int32_t y = 0;                                   ///< Координата y нажатия мыши
+    std::string text;                                ///< Введенный текст (до 255 байт)
+};
+
+/**
+ * @class InputRecorder
+ * @brief Дописывает события в файл записи
+ *
+ * События буферизуются в памяти и сбрасываются на диск при заполнении
+ * буфера и в деструкторе, чтобы запись не добавляла файловый ввод-вывод
+ * к обработке каждого события.
+ */
+class InputRecorder {
+public:
+    /**
+     * @brief Создать файл записи и записать заголовок
+     * @param path Путь к файлу
+     * @param seed Начальное значение генератора случайных чисел игры
+     * @throw std::runtime_error Если файл не создается
+     */
+    InputRecorder(const std::string& path, uint32_t seed);
+
+    /**
+     * @brief Записать событие
+     * @param event Событие
+     */
+    void record(const RecordedEvent& event);
+
+private:
+    std::ofstream out; ///< Файл записи
+};
+
+/**
+ * @struct InputRecording
+ * @brief Загруженная запись ввода
+ */
+struct InputRecording {
+    uint32_t seed = 0;                ///< Начальное значение генератора случайных чисел
+    std::vector<RecordedEvent> events; ///< События по возрастанию времени
+
+    /**
+     * @brief Загрузить запись из файла
+     * @param path Путь к файлу
+     * @return Запись
+     * @throw std::runtime_error Если файл не открывается или поврежден
+     */
+    static InputRecording load(const std::string& path);
+};
+
+#endif
@@ -0,0 +1,90 @@
+/**
+ * @file label.h
+ * @brief Текстовая метка с кэшированной геометрией
+ */
+
+#ifndef LABEL_H
+#define LABEL_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "render_batch.h"
+#include "text_renderer.h"
+
+/**
+ * @enum LabelAlign
+ * @brief Горизонтальное выравнивание метки относительно точки привязки
+ */
+enum class LabelAlign {
+    LEFT,  ///< Точка привязки - левая граница
+    CENTER ///< Точка привязки - центр
+};
+
+/**
+ * @class Label
+ * @brief Метка, которая перестраивается только при изменении текста
+ * 
+ * Четырехугольники глифов хранятся между кадрами и пересчитываются лишь
+ * после изменения текста, цвета или положения, поэтому вывод неизменной
+ * метки сводится к копированию вершин в пакет кадра.
+ */
+class Label {
+public:
+    /**
+     * @brief Конструктор
+     * @param textRenderer Атлас шрифта метки
+     * @param color Цвет текста
+     */
+    explicit Label(TextRenderer& textRenderer, SDL_Color color = SDL_Color{0, 0, 0, 255});
+
+    /**
+     * @brief Задать текст (метка помечается измененной, только если он другой)
+     * @param newText Текст в UTF-8
+     */
+    void setText(std::string_view newText);
+
+    /**
+     * @brief Задать цвет текста
+     * @param newColor Цвет
+     */
+    void setColor(SDL_Color newColor);
+
+    /**
+     * @brief Задать положение
+     * @param x Горизонтальная точка привязки
+     * @param y Верхняя граница
+     * @param newAlign Выравнивание относительно x
+     */
+    void place(int x, int y, LabelAlign newAlign = LabelAlign::LEFT);
+
+    /**
+     * @brief Текущий текст
+     * @return Текст метки
+     */
+    const std::string& text() const;
+
+    /**
+     * @brief Добавить метку в пакет кадра, при необходимости перестроив геометрию
+     * @param batch Пакет кадра
+     */
+    void draw(RenderBatch& batch);
+
+private:
+    TextRenderer& textRenderer; ///< Атлас шрифта
+    std::string str;            ///< Текст
+    SDL_Color color;            ///< Цвет текста
+    int x;                      ///< Горизонтальная точка привязки
+    int y;                      ///< Верхняя граница
+    LabelAlign align;           ///< Выравнивание
+    bool dirty;                 ///< Геометрия устарела
+    std::vector<SDL_Vertex> vertices; ///< Кэшированные вершины
+    std::vector<int> indices;         ///< Кэшированные индексы
+
+    /**
+     * @brief Перестроить геометрию метки
+     */
+    void rebuild();
+};
+
+#endif
@@ -0,0 +1,111 @@
+/**
+ * @file latency_tracker.h
+ * @brief Задержка от ввода до вывода кадра
+ */
+
+#ifndef LATENCY_TRACKER_H
+#define LATENCY_TRACKER_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+
+/**
+ * @struct LatencySummary
+ * @brief Сводка задержек за сессию
+ */
+struct LatencySummary {
+    uint64_t count = 0;  ///< Количество измеренных событий
+    uint64_t dropped = 0; ///< События, не дождавшиеся кадра (переполнение очереди)
+    double meanMs = 0;   ///< Средняя задержка
+    double maxMs = 0;    ///< Максимальная задержка
+    double p50Ms = 0;    ///< Медиана (верхняя граница корзины гистограммы)
+    double p95Ms = 0;    ///< 95-й процентиль (верхняя граница корзины)
+    double p99Ms = 0;    ///< 99-й процентиль (верхняя граница корзины)
+};
+
+/**
+ * @class LatencyTracker
+ * @brief Гистограмма задержки от события ввода до первого кадра, показавшего его результат
+ *
+ * Логика сообщает о событии вместе с версией состояния, которую оно создало;
+ * отрисовка сообщает о каждом выведенном кадре и версии, которую он показал.
+ * Событие считается показанным первым кадром с версией не меньше своей.
+ * Методы потокобезопасны: события и кадры могут приходить из разных потоков.
+ */
+class LatencyTracker {
+public:
+    using Clock = std::chrono::steady_clock; ///< Часы измерений
+
+    /**
+     * @brief Количество корзин гистограммы (последняя - больше 1 с)
+     */
+    static constexpr size_t BUCKETS = 17;
+
+    /**
+     * @brief Верхние границы корзин в миллисекундах
+     */
+    static const std::array<double, BUCKETS - 1> BUCKET_BOUNDS_MS;
+
+    /**
+     * @brief Конструктор
+     */
+    LatencyTracker();
+
+    /**
+     * @brief Учесть событие ввода, изменившее состояние
+     * @param revision Версия состояния после обработки события
+     * @param occurred Момент события
+     */
+    void inputApplied(uint64_t revision, Clock::time_point occurred);
+
+    /**
+     * @brief Учесть выведенный кадр
+     * @param revision Версия состояния, показанная кадром
+     * @param presented Момент вывода кадра
+     */
+    void framePresented(uint64_t revision, Clock::time_point presented);
+
+    /**
+     * @brief Посчитать сводку
+     * @return Сводка
+     */
+    LatencySummary summary() const;
+
+    /**
+     * @brief Сводка и гистограмма в формате JSON
+     * @return Объект JSON в одну строку
+     */
+    std::string toJson() const;
+
+private:
+    /**
+     * @struct PendingInput
+     * @brief Событие, результат которого еще не выведен
+     */
+    struct PendingInput {
+        uint64_t revision;         ///< Версия состояния после события
+        Clock::time_point occurred; ///< Момент события
+    };
+
+    mutable std::mutex mutex;               ///< Защищает все поля
+    std::deque<PendingInput> pending;       ///< Ожидающие кадра события по возрастанию версии
+    std::array<uint64_t, BUCKETS> buckets;  ///< Гистограмма
+    uint64_t count;                         ///< Количество измерений
+    uint64_t dropped;                       ///< Количество отброшенных событий
+    double totalMs;                         ///< Сумма задержек
+    double maxMs;                           ///< Максимальная задержка
+    Clock::time_point started;              ///< Начало сессии
+
+    /**
+     * @brief Оценить процентиль по гистограмме
+     * @param fraction Доля (0-1)
+     * @return Верхняя граница корзины, в которую попал процентиль
+     */
+    double percentile(double fraction) const;
+};
+
+#endif
@@ -0,0 +1,124 @@
+/**
+ * @file memory_tracking.h
+ * @brief Учет выделений памяти по подсистемам
+ *
+ * При сборке с опцией CMake AIP_MEMORY_TRACKING глобальные operator new и
+ * delete, а также распределители SQLite (installSqliteMemoryHooks) и SDL
+ * (trackedMalloc и другие для SDL_SetMemoryFunctions) считают байты и
+ * выделения той подсистемы, чья область AIP_MEMORY_SCOPE активна в потоке.
+ * Память SQLite всегда относится к DATABASE. Без опции макрос ничего не
+ * делает, а счетчики остаются нулевыми.
+ */
+
+#ifndef MEMORY_TRACKING_H
+#define MEMORY_TRACKING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @enum MemorySubsystem
+ * @brief Подсистемы, которым приписываются выделения
+ */
+enum class MemorySubsystem : uint8_t {
+    OTHER,      ///< Вне отмеченных областей
+    CIPHER,     ///< Шифрование и создание головоломок
+    DATABASE,   ///< Запросы к базе данных и SQLite
+    TEXT,       ///< Отрисовка текста и кадра
+    GAME_STATE, ///< Изменение и копирование состояния игры
+    COUNT       ///< Количество подсистем
+};
+
+/**
+ * @struct MemoryUsage
+ * @brief Счетчики выделений подсистемы (или всех подсистем)
+ */
+struct MemoryUsage {
+    uint64_t allocations = 0;    ///< Выделений с начала работы
+    uint64_t frees = 0;          ///< Освобождений с начала работы
+    uint64_t allocatedBytes = 0; ///< Выделено байт с начала работы
+    int64_t currentBytes = 0;    ///< Занято сейчас
+    int64_t peakBytes = 0;       ///< Наибольшее занятое значение
+};
+
+/// Учет памяти собран в программу
+#ifdef AIP_MEMORY_TRACKING
+constexpr bool MEMORY_TRACKING_ENABLED = true;
+#else
+constexpr bool MEMORY_TRACKING_ENABLED = false;
+#endif
+
+/**
+ * @brief Название подсистемы для отчетов
+ */
+const char* memorySubsystemName(MemorySubsystem subsystem);
+
+/**
+ * @brief Счетчики одной подсистемы
+ */
+MemoryUsage memoryUsage(MemorySubsystem subsystem);
+
+/**
+ * @brief Счетчики всех подсистем вместе (пик - общий для процесса)
+ */
+MemoryUsage totalMemoryUsage();
+
+/**
+ * @brief Счетчики всех подсистем в JSON
+ */
+std::string memoryUsageJson();
+
+#ifdef AIP_MEMORY_TRACKING
+
+/// Подсистема, которой приписываются выделения текущего потока
+inline thread_local MemorySubsystem currentMemorySubsystem = MemorySubsystem::OTHER;
+
+/**
+ * @class MemoryScope
+ * @brief Приписывает выделения потока подсистеме до конца области видимости
+ */
+class MemoryScope {
+public:
+    explicit MemoryScope(MemorySubsystem subsystem) : previous(currentMemorySubsystem) {
+        currentMemorySubsystem = subsystem;
+    }
+
+    ~MemoryScope() {
+        currentMemorySubsystem = previous;
+    }
+
+    MemoryScope(const MemoryScope&) = delete;
+    MemoryScope& operator=(const MemoryScope&) = delete;
+
+private:
+    MemorySubsystem previous; ///< Подсистема внешней области
+};
+
+#define AIP_MEMORY_CONCAT_(a, b) a##b
+#define AIP_MEMORY_CONCAT(a, b) AIP_MEMORY_CONCAT_(a, b)
+#define AIP_MEMORY_SCOPE(subsystem) MemoryScope AIP_MEMORY_CONCAT(memoryScope, __LINE__)(MemorySubsystem::subsystem)
+
+/**
+ * @brief Распределители с учетом (сигнатуры SDL_SetMemoryFunctions)
+ */
+void* trackedMalloc(size_t size);
+void* trackedCalloc(size_t count, size_t size);
+void* trackedRealloc(void* pointer, size_t size);
+void trackedFree(void* pointer);
+
+/**
+ * @brief Направить выделения SQLite через учет (до первого обращения к SQLite)
+ * @throw std::runtime_error Если SQLite уже инициализирована
+ */
+void installSqliteMemoryHooks();
+
+#else
+
+#define AIP_MEMORY_SCOPE(subsystem) ((void)0)
+
+inline void installSqliteMemoryHooks() {}
+
+#endif
+
+#endif
@@ -0,0 +1,207 @@
+/**
+ * @file metrics.h
+ * @brief Счетчики и гистограммы работы программы для внешнего мониторинга
+ *
+ * Метрики регистрируются в MetricsRegistry и обновляются из любых потоков
+ * без блокировок. MetricsWriter периодически записывает их в файл в
+ * текстовом формате Prometheus или в JSON; сетевого доступа нет, файл
+ * забирает локальный агент.
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @class Counter
+ * @brief Монотонный счетчик
+ *
+ * Значение разбито на части по потокам, чтобы потоки не делили одну
+ * кэш-линию; value() складывает части.
+ */
+class Counter {
+public:
+    /**
+     * @brief Прибавить значение
+     * @param amount Прибавка
+     */
+    void add(uint64_t amount = 1);
+
+    /**
+     * @brief Текущее значение
+     */
+    uint64_t value() const;
+
+private:
+    static constexpr size_t SHARDS = 16;
+
+    /**
+     * @struct Shard
+     * @brief Часть счетчика в отдельной кэш-линии
+     */
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> value{0}; ///< Сумма прибавок потоков этой части
+    };
+
+    std::array<Shard, SHARDS> shards; ///< Части счетчика
+};
+
+/**
+ * @struct HistogramSnapshot
+ * @brief Значения гистограммы на момент чтения
+ */
+struct HistogramSnapshot {
+    std::vector<double> bounds;   ///< Верхние границы корзин
+    std::vector<uint64_t> counts; ///< Количество в корзинах (последняя - выше всех границ)
+    uint64_t count = 0;           ///< Всего наблюдений
+    double sum = 0;               ///< Сумма наблюдений
+};
+
+/**
+ * @class Histogram
+ * @brief Гистограмма с фиксированными границами корзин
+ */
+class Histogram {
+public:
+    /**
+     * @brief Конструктор
+     * @param bounds Верхние границы корзин по возрастанию
+     */
+    explicit Histogram(std::vector<double> bounds);
+
+    /**
+     * @brief Добавить наблюдение
+     * @param value Значение
+     */
+    void observe(double value);
+
+    /**
+     * @brief Прочитать значения
+     */
+    HistogramSnapshot snapshot() const;
+
+private:
+    std::vector<double> bounds;                    ///< Верхние границы корзин
+    std::unique_ptr<std::atomic<uint64_t>[]> counts; ///< Корзины (bounds.size() + 1)
+    std::atomic<double> sum;                       ///< Сумма наблюдений
+};
+
+/// Метки метрики: пары имя-значение, например {{"sql", "SELECT ..."}}
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+/**
+ * @class MetricsRegistry
+ * @brief Именованные метрики
+ *
+ * Метрика определяется именем и набором меток; метрики с одним именем и
+ * разными метками выводятся вместе, как в Prometheus. Ссылки на
+ * зарегистрированные метрики действительны все время жизни реестра.
+ */
+class MetricsRegistry {
+public:
+    /**
+     * @brief Найти или создать счетчик
+     * @param name Имя в формате Prometheus (например, aip_rounds_started_total)
+     * @param help Описание
+     * @param labels Метки
+     */
+    Counter& counter(const std::string& name, const std::string& help, const MetricLabels& labels = {});
+
+    /**
+     * @brief Найти или создать гистограмму
+     * @param name Имя в формате Prometheus
+     * @param help Описание
+     * @param bounds Верхние границы корзин (используются только при создании)
+     * @param labels Метки
+     */
+    Histogram& histogram(const std::string& name, const std::string& help, const std::vector<double>& bounds,
+                         const MetricLabels& labels = {});
+
+    /**
+     * @brief Все метрики в текстовом формате Prometheus
+     */
+    std::string toPrometheus() const;
+
+    /**
+     * @brief Все метрики в JSON
+     */
+    std::string toJson() const;
+
+private:
+    template <typename T>
+    struct Entry {
+        std::string help;          ///< Описание
+        std::unique_ptr<T> metric; ///< Метрика
+    };
+
+    /// Имя и метки в формате Prometheus (name="value",...)
+    using Key = std::pair<std::string, std::string>;
+
+    mutable std::mutex mutex;                     ///< Защищает словари (не значения метрик)
+    std::map<Key, Entry<Counter>> counters;       ///< Счетчики
+    std::map<Key, Entry<Histogram>> histograms;   ///< Гистограммы
+};
+
+/**
+ * @brief Общий реестр метрик программы
+ */
+MetricsRegistry& metrics();
+
+/**
+ * @brief Границы корзин для длительностей в секундах (от 10 мкс до 1 с)
+ */
+const std::vector<double>& latencyBuckets();
+
+/**
+ * @class MetricsWriter
+ * @brief Фоновая периодическая запись метрик в файл
+ *
+ * Файл заменяется целиком через переименование, чтобы читатель не увидел
+ * его наполовину записанным. Формат - JSON для имени на .json, иначе Prometheus.
+ */
+class MetricsWriter {
+public:
+    /**
+     * @brief Запустить запись
+     * @param registry Реестр
+     * @param path Путь к файлу
+     * @param interval Период записи
+     */
+    MetricsWriter(const MetricsRegistry& registry, std::string path, std::chrono::milliseconds interval);
+
+    /**
+     * @brief Остановить поток и записать итоговые значения
+     */
+    ~MetricsWriter();
+
+    /**
+     * @brief Записать файл сейчас
+     * @throw std::runtime_error Если файл не записывается
+     */
+    void write() const;
+
+private:
+    const MetricsRegistry& registry;    ///< Реестр
+    std::string path;                   ///< Путь к файлу
+    std::chrono::milliseconds interval; ///< Период записи
+    std::mutex mutex;                   ///< Защищает stopping
+    std::condition_variable wake;       ///< Будит поток при остановке
+    bool stopping;                      ///< Поток должен завершиться
+    std::thread thread;                 ///< Поток записи
+
+    void loop();
+};
+
+#endif
@@ -0,0 +1,94 @@
+/**
+ * @file puzzle_prefetcher.h
+ * @brief Фоновая подготовка головоломок
+ */
+
+#ifndef PUZZLE_PREFETCHER_H
+#define PUZZLE_PREFETCHER_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include "ciphers.h"
+#include "game_core.h"
+#include "spsc_queue.h"
+
+/**
+ * @class PuzzlePrefetcher
+ * @brief Держит наготове несколько головоломок для каждого шифра
+ *
+ * Фоновый поток вызывает источник головоломок и заполняет по одной
+ * ограниченной очереди на каждый CipherType. next() забирает готовую
+ * головоломку за постоянное время без обращения к базе данных. Только
+ * если очередь пуста (например, сразу после запуска), next() ждет
+ * фоновый поток.
+ *
+ * Источник вызывается только из фонового потока, поэтому generatePuzzle
+ * с его глобальной базой данных и rand() не нужно делать потокобезопасным.
+ * Порядок вызовов источника определяется только порядком вызовов next().
+ */
+class PuzzlePrefetcher {
+public:
+    /**
+     * @brief Конструктор, запускает фоновый поток
+     * @param source Источник головоломок
+     * @param capacity Количество готовых головоломок на каждый шифр
+     */
+    explicit PuzzlePrefetcher(PuzzleSource source = generatePuzzle, size_t capacity = 4);
+
+    /**
+     * @brief Деструктор, останавливает фоновый поток
+     */
+    ~PuzzlePrefetcher();
+
+    PuzzlePrefetcher(const PuzzlePrefetcher&) = delete;
+    PuzzlePrefetcher& operator=(const PuzzlePrefetcher&) = delete;
+
+    /**
+     * @brief Взять готовую головоломку
+     *
+     * Вызывается из одного потока.
+     * @param cipherType Тип шифра
+     * @return Головоломка
+     * @throw Исключение, выброшенное источником в фоновом потоке
+     */
+    Puzzle next(CipherType cipherType);
+
+    /**
+     * @brief Количество вызовов next(), которым пришлось ждать фоновый поток
+     * @return Количество промахов
+     */
+    uint64_t misses() const;
+
+private:
+    PuzzleSource source;                    ///< Источник головоломок
+    size_t capacity;                        ///< Количество готовых головоломок на каждый шифр
+    std::array<SpscQueue<Puzzle>, 3> queues; ///< Готовые головоломки по типам шифров
+    SpscQueue<CipherType> refills;          ///< Шифры взятых головоломок в порядке вызовов next()
+    std::atomic<uint64_t> missCount;        ///< Количество промахов next()
+
+    std::mutex mutex;                       ///< Защищает stopping и failure, нужен для ожидания
+    std::condition_variable producerWake;   ///< Будит фоновый поток после next()
+    std::condition_variable consumerWake;   ///< Будит next() после новой головоломки
+    bool stopping;                          ///< Фоновый поток должен завершиться
+    std::exception_ptr failure;             ///< Ошибка источника
+    std::thread producer;                   ///< Фоновый поток
+
+    /**
+     * @brief Тело фонового потока
+     */
+    void produce();
+
+    /**
+     * @brief Создать головоломку и положить ее в очередь шифра
+     * @param cipherType Тип шифра
+     * @return false если фоновый поток должен завершиться
+     */
+    bool produceOne(CipherType cipherType);
+};
+
+#endif
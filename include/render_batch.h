@@ -0,0 +1,133 @@
+/**
+ * @file render_batch.h
+ * @brief Пакетный вывод прямоугольников и текста через SDL_RenderGeometry
+ */
+
+#ifndef RENDER_BATCH_H
+#define RENDER_BATCH_H
+
+#include <SDL2/SDL.h>
+#include <utility>
+#include <vector>
+
+/**
+ * @struct RenderStats
+ * @brief Статистика вывода одного кадра
+ */
+struct RenderStats {
+    int drawCalls = 0; ///< Количество вызовов SDL_RenderGeometry
+    int vertices = 0;  ///< Количество отправленных вершин
+    int texturesCreated = 0;   ///< Сколько текстур создано с конца прошлого кадра
+    int texturesDestroyed = 0; ///< Сколько текстур уничтожено с конца прошлого кадра
+    int textureUploads = 0;    ///< Сколько раз в текстуры загружались пиксели
+};
+
+/**
+ * @brief Учесть создание текстуры в статистике кадра
+ * 
+ * Счетчики текстур общие для процесса; RenderBatch::endFrame
+ * записывает в статистику их изменение за кадр.
+ */
+void countTextureCreated();
+
+/**
+ * @brief Учесть уничтожение текстуры в статистике кадра
+ */
+void countTextureDestroyed();
+
+/**
+ * @brief Учесть загрузку пикселей в текстуру в статистике кадра
+ */
+void countTextureUpload();
+
+/**
+ * @class RenderBatch
+ * @brief Собирает геометрию кадра в общий буфер вершин
+ * 
+ * Прямоугольники и четырехугольники глифов копятся в одном буфере и
+ * отправляются одним вызовом SDL_RenderGeometry на каждую смену текстуры.
+ * Сплошные прямоугольники рисуются белым блоком текущего атласа, поэтому
+ * не прерывают пакет текста.
+ */
+class RenderBatch {
+public:
+    /**
+     * @brief Конструктор
+     * @param renderer SDL рендерер
+     */
+    explicit RenderBatch(SDL_Renderer* renderer);
+
+    /**
+     * @brief Зарегистрировать текстуру с белым блоком для сплошной заливки
+     * 
+     * Первая зарегистрированная текстура используется, если текущая
+     * текстура пакета не зарегистрирована.
+     * @param texture Текстура
+     * @param texel Текстурная координата белого блока
+     */
+    void addSolidSource(SDL_Texture* texture, SDL_FPoint texel);
+
+    /**
+     * @brief Залить прямоугольник
+     * @param rect Прямоугольник
+     * @param color Цвет
+     */
+    void fillRect(const SDL_Rect& rect, SDL_Color color);
+
+    /**
+     * @brief Нарисовать рамку прямоугольника толщиной 1 пиксель
+     * @param rect Прямоугольник
+     * @param color Цвет
+     */
+    void drawRect(const SDL_Rect& rect, SDL_Color color);
+
+    /**
+     * @brief Добавить готовую геометрию
+     * @param texture Текстура геометрии
+     * @param vertices Вершины
+     * @param indices Индексы
+     */
+    void addGeometry(SDL_Texture* texture, const std::vector<SDL_Vertex>& vertices,
+                     const std::vector<int>& indices);
+
+    /**
+     * @brief Отправить накопленную геометрию
+     */
+    void flush();
+
+    /**
+     * @brief Завершить кадр: отправить геометрию и сохранить статистику
+     */
+    void endFrame();
+
+    /**
+     * @brief Статистика последнего завершенного кадра
+     * @return Статистика
+     */
+    const RenderStats& lastFrame() const;
+
+private:
+    SDL_Renderer* renderer;   ///< SDL рендерер
+    SDL_Texture* current;     ///< Текстура текущего пакета
+    std::vector<std::pair<SDL_Texture*, SDL_FPoint>> solidSources; ///< Текстуры с белым блоком
+    std::vector<SDL_Vertex> vertices; ///< Вершины текущего пакета
+    std::vector<int> indices;         ///< Индексы текущего пакета
+    RenderStats frame;        ///< Статистика текущего кадра
+    RenderStats last;         ///< Статистика последнего кадра
+    RenderStats textureMarks; ///< Значения счетчиков текстур в конце прошлого кадра
+
+    /**
+     * @brief Переключить пакет на текстуру, отправив предыдущий при смене
+     * @param texture Текстура
+     */
+    void use(SDL_Texture* texture);
+
+    /**
+     * @brief Добавить сплошной четырехугольник
+     * @param rect Прямоугольник
+     * @param color Цвет
+     */
+    void addSolidQuad(const SDL_Rect& rect, SDL_Color color);
+};
+
+#endif
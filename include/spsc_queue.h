@@ -0,0 +1,86 @@
+/**
+ * @file spsc_queue.h
+ * @brief Ограниченная очередь без блокировок для одного производителя и одного потребителя
+ */
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * @class SpscQueue
+ * @brief Кольцевой буфер фиксированного размера
+ *
+ * push() вызывается только из потока производителя, pop() - только из
+ * потока потребителя. Обе операции выполняются за постоянное время и
+ * не выделяют память.
+ * @tparam T Тип элемента
+ */
+template <typename T>
+class SpscQueue {
+public:
+    /**
+     * @brief Конструктор
+     * @param capacity Максимальное количество элементов в очереди
+     */
+    explicit SpscQueue(size_t capacity) : slots(capacity + 1) {}
+
+    /**
+     * @brief Добавить элемент (поток производителя)
+     * @param value Элемент
+     * @return false если очередь заполнена; элемент при этом не перемещается
+     */
+    bool push(T&& value) {
+        size_t tail = tailIndex.load(std::memory_order_relaxed);
+        size_t next = advance(tail);
+        if (next == headIndex.load(std::memory_order_acquire)) {
+            return false;
+        }
+        slots[tail] = std::move(value);
+        tailIndex.store(next, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Извлечь элемент (поток потребителя)
+     * @param value Куда переместить элемент
+     * @return false если очередь пуста
+     */
+    bool pop(T& value) {
+        size_t head = headIndex.load(std::memory_order_relaxed);
+        if (head == tailIndex.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = std::move(slots[head]);
+        headIndex.store(advance(head), std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Проверить, заполнена ли очередь (поток производителя)
+     * @return true если push() сейчас вернет false
+     */
+    bool full() const {
+        return advance(tailIndex.load(std::memory_order_relaxed)) == headIndex.load(std::memory_order_acquire);
+    }
+
+private:
+    std::vector<T> slots;                          ///< Элементы; один слот всегда свободен
+    alignas(64) std::atomic<size_t> headIndex{0};  ///< Следующий элемент для pop()
+    alignas(64) std::atomic<size_t> tailIndex{0};  ///< Следующий свободный слот для push()
+
+    /**
+     * @brief Следующий индекс по кольцу
+     * @param index Индекс слота
+     * @return Индекс следующего слота
+     */
+    size_t advance(size_t index) const {
+        return index + 1 == slots.size() ? 0 : index + 1;
+    }
+};
+
+#endif
@@ -0,0 +1,133 @@
+/**
+ * @file text_renderer.h
+ * @brief Вывод текста через атлас глифов
+ */
+
+#ifndef TEXT_RENDERER_H
+#define TEXT_RENDERER_H
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class TextRenderer
+ * @brief Текстовый рендерер на основе атласа глифов одного шрифта
+ * 
+ * Каждый глиф растеризуется один раз и загружается в общую текстуру-атлас.
+ * Строка выводится одним вызовом SDL_RenderGeometry из четырехугольников
+ * глифов, а ширина строки считается по закэшированным метрикам.
+ */
+class TextRenderer {
+public:
+    /**
+     * @brief Создать атлас для шрифта
+     * @param renderer SDL рендерер
+     * @param font Шрифт нужного размера (должен жить дольше рендерера текста)
+     * @throw std::runtime_error Если не удалось создать текстуру атласа
+     */
+    TextRenderer(SDL_Renderer* renderer, TTF_Font* font);
+
+    /**
+     * @brief Деструктор, освобождает текстуру атласа
+     */
+    ~TextRenderer();
+
+    TextRenderer(const TextRenderer&) = delete;
+    TextRenderer& operator=(const TextRenderer&) = delete;
+
+    /**
+     * @brief Вычислить ширину строки в пикселях
+     * @param text Строка в UTF-8
+     * @return Ширина строки
+     */
+    int measure(const std::string& text);
+
+    /**
+     * @brief Высота строки шрифта в пикселях
+     * @return Высота строки
+     */
+    int lineHeight() const;
+
+    /**
+     * @brief Текстура атласа
+     * @return Текстура
+     */
+    SDL_Texture* texture() const;
+
+    /**
+     * @brief Текстурная координата белого блока атласа
+     * 
+     * Позволяет выводить сплошные прямоугольники той же текстурой,
+     * что и текст, без переключения текстуры.
+     * @return Текстурная координата
+     */
+    SDL_FPoint solidTexel() const;
+
+    /**
+     * @brief Вывести строку
+     * @param text Строка в UTF-8
+     * @param x Левая граница
+     * @param y Верхняя граница
+     * @param color Цвет текста
+     */
+    void draw(const std::string& text, int x, int y, SDL_Color color);
+
+    /**
+     * @brief Построить четырехугольники глифов строки
+     * @param text Строка в UTF-8
+     * @param x Левая граница
+     * @param y Верхняя граница
+     * @param color Цвет текста
+     * @param vertices Буфер, в конец которого добавляются вершины
+     * @param indices Буфер, в конец которого добавляются индексы
+     * @return Ширина строки
+     */
+    int layout(const std::string& text, int x, int y, SDL_Color color,
+               std::vector<SDL_Vertex>& vertices, std::vector<int>& indices);
+
+    /**
+     * @brief Вывести готовые четырехугольники, построенные layout()
+     * @param vertices Вершины
+     * @param indices Индексы
+     */
+    void drawGeometry(const std::vector<SDL_Vertex>& vertices, const std::vector<int>& indices);
+
+private:
+    /**
+     * @struct Glyph
+     * @brief Положение глифа в атласе и его метрики
+     */
+    struct Glyph {
+        SDL_Rect source; ///< Прямоугольник глифа в атласе (w == 0 для пустых глифов)
+        int advance;     ///< Смещение пера после глифа
+    };
+
+    SDL_Renderer* renderer; ///< SDL рендерер
+    TTF_Font* font;         ///< Шрифт атласа
+    SDL_Texture* atlas;     ///< Текстура-атлас
+    int height;             ///< Высота строки шрифта
+    int penX;               ///< Позиция следующего глифа в текущей строке атласа
+    int penY;               ///< Верхняя граница текущей строки атласа
+    std::unordered_map<Uint32, Glyph> glyphs; ///< Уже растеризованные глифы
+    std::vector<SDL_Vertex> vertices;         ///< Буфер вершин строки
+    std::vector<int> indices;                 ///< Буфер индексов строки
+
+    /**
+     * @brief Найти глиф в атласе, при необходимости растеризовав его
+     * @param codepoint Код символа
+     * @return Глиф
+     */
+    const Glyph& glyph(Uint32 codepoint);
+
+    /**
+     * @brief Растеризовать глиф и загрузить его в атлас
+     * @param codepoint Код символа
+     * @return Глиф
+     */
+    Glyph rasterize(Uint32 codepoint);
+};
+
+#endif
@@ -0,0 +1,109 @@
+/**
+ * @file trace.h
+ * @brief Профилирование участков кода в формате Chrome trace
+ *
+ * AIP_TRACE_SCOPE("имя") замеряет время до конца области видимости.
+ * Каждый поток пишет события в свой кольцевой буфер без блокировок,
+ * writeTraceFile сохраняет последние TRACE_BUFFER_EVENTS событий каждого
+ * потока в JSON для chrome://tracing и Perfetto.
+ * Без опции CMake AIP_TRACING макрос ничего не делает, а функции пусты.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <string>
+
+#ifdef AIP_TRACING
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/// Трассировка собрана в программу
+constexpr bool TRACING_ENABLED = true;
+
+/// Событий в кольцевом буфере одного потока; новые события вытесняют самые старые
+constexpr size_t TRACE_BUFFER_EVENTS = 1 << 16;
+
+/// Запись событий включена (setTracingEnabled)
+inline std::atomic<bool> tracingActive{false};
+
+/**
+ * @brief Текущее время трассировки в наносекундах
+ */
+inline uint64_t traceNow() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * @brief Добавить завершенный участок в буфер текущего потока
+ * @param name Имя участка (строковый литерал: хранится только указатель)
+ * @param startNs Начало по traceNow()
+ * @param durationNs Длительность
+ */
+void traceRecord(const char* name, uint64_t startNs, uint64_t durationNs);
+
+/**
+ * @class TraceScope
+ * @brief Замер участка от конструктора до деструктора
+ */
+class TraceScope {
+public:
+    explicit TraceScope(const char* name)
+        : name(name), startNs(tracingActive.load(std::memory_order_relaxed) ? traceNow() : 0) {}
+
+    ~TraceScope() {
+        if (startNs) {
+            traceRecord(name, startNs, traceNow() - startNs);
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name; ///< Имя участка
+    uint64_t startNs; ///< Начало участка (0 - трассировка была выключена)
+};
+
+#define AIP_TRACE_CONCAT_(a, b) a##b
+#define AIP_TRACE_CONCAT(a, b) AIP_TRACE_CONCAT_(a, b)
+#define AIP_TRACE_SCOPE(name) TraceScope AIP_TRACE_CONCAT(traceScope, __LINE__)(name)
+
+/**
+ * @brief Включить или выключить запись событий
+ */
+void setTracingEnabled(bool enabled);
+
+/**
+ * @brief Задать имя текущего потока в трассе
+ * @param name Имя (строковый литерал)
+ */
+void setTraceThreadName(const char* name);
+
+/**
+ * @brief Записать события всех потоков в файл JSON
+ *
+ * Можно вызывать во время работы: потоки продолжают писать события,
+ * в файл попадают уже завершенные. Вытесненные из буферов события
+ * учитываются в otherData.dropped_events.
+ * @param path Путь к файлу
+ * @throw std::runtime_error Если файл не записывается
+ */
+void writeTraceFile(const std::string& path);
+
+#else
+
+constexpr bool TRACING_ENABLED = false;
+
+#define AIP_TRACE_SCOPE(name) ((void)0)
+
+inline void setTracingEnabled(bool) {}
+inline void setTraceThreadName(const char*) {}
+inline void writeTraceFile(const std::string&) {}
+
+#endif
+
+#endif
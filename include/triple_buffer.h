@@ -0,0 +1,71 @@
+/**
+ * @file triple_buffer.h
+ * @brief Тройной буфер для передачи снимков состояния между двумя потоками
+ */
+
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <array>
+#include <atomic>
+
+/**
+ * @class TripleBuffer
+ * @brief Тройной буфер без блокировок для одного писателя и одного читателя
+ *
+ * Писатель заполняет back() и вызывает publish(), читатель вызывает update()
+ * и читает front(). Ни одна из сторон не ждет другую: писатель всегда может
+ * записать новый снимок, а читатель всегда видит последний целиком
+ * опубликованный снимок. Промежуточные снимки, которые читатель не успел
+ * забрать, пропускаются.
+ * @tparam T Тип снимка
+ */
+template <typename T>
+class TripleBuffer {
+public:
+    /**
+     * @brief Буфер писателя
+     * @return Снимок, который будет опубликован следующим
+     */
+    T& back() {
+        return slots[backIndex];
+    }
+
+    /**
+     * @brief Опубликовать заполненный буфер писателя
+     */
+    void publish() {
+        backIndex = middle.exchange(backIndex | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    /**
+     * @brief Забрать последний опубликованный снимок
+     * @return true если с прошлого вызова был опубликован новый снимок
+     */
+    bool update() {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) {
+            return false;
+        }
+        frontIndex = middle.exchange(frontIndex, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    /**
+     * @brief Буфер читателя
+     * @return Снимок, полученный последним вызовом update()
+     */
+    const T& front() const {
+        return slots[frontIndex];
+    }
+
+private:
+    static constexpr unsigned INDEX_MASK = 3; ///< Биты индекса в middle
+    static constexpr unsigned FRESH = 4;      ///< Бит "в middle лежит непрочитанный снимок"
+
+    std::array<T, 3> slots;           ///< Три снимка
+    unsigned backIndex = 0;           ///< Буфер писателя (только поток писателя)
+    std::atomic<unsigned> middle{1};  ///< Буфер обмена и бит FRESH
+    unsigned frontIndex = 2;          ///< Буфер читателя (только поток читателя)
+};
+
+#endif
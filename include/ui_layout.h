@@ -0,0 +1,125 @@
+/**
+ * @file ui_layout.h
+ * @brief Декларативная раскладка экранов и поиск виджета под курсором
+ */
+
+#ifndef UI_LAYOUT_H
+#define UI_LAYOUT_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @enum Screen
+ * @brief Экраны игры
+ */
+enum class Screen {
+    MAIN_MENU, ///< Выбор шифра
+    CIPHER,    ///< Расшифровка слова
+    RESULT     ///< Результат раунда
+};
+
+/**
+ * @enum WidgetId
+ * @brief Виджеты интерфейса
+ */
+enum class WidgetId {
+    CAESAR_BUTTON,   ///< Выбор шифра Цезаря
+    AFFINE_BUTTON,   ///< Выбор аффинного шифра
+    VIGENERE_BUTTON, ///< Выбор шифра Виженера
+    INPUT_BOX,       ///< Поле ввода ответа
+    MENU_BUTTON,     ///< Возврат в меню
+    HINT1_BUTTON,    ///< Первая подсказка
+    HINT2_BUTTON,    ///< Вторая подсказка
+    SAME_BUTTON,     ///< Новый раунд того же шифра
+    NEW_BUTTON,      ///< Возврат к выбору шифра
+    COUNT            ///< Количество виджетов
+};
+
+/**
+ * @enum WidgetKind
+ * @brief Вид виджета (определяет отрисовку и реакцию на нажатие)
+ */
+enum class WidgetKind {
+    BUTTON,  ///< Кнопка с подписью
+    TEXT_BOX ///< Поле ввода, не реагирует на нажатие
+};
+
+/**
+ * @struct UiRect
+ * @brief Прямоугольник виджета в пикселях окна
+ */
+struct UiRect {
+    int x; ///< Левая граница
+    int y; ///< Верхняя граница
+    int w; ///< Ширина
+    int h; ///< Высота
+
+    /**
+     * @brief Проверить попадание точки (границы включаются)
+     * @param px Координата x
+     * @param py Координата y
+     * @return true если точка внутри прямоугольника или на его границе
+     */
+    bool contains(int px, int py) const;
+};
+
+/**
+ * @struct Widget
+ * @brief Описание виджета экрана
+ */
+struct Widget {
+    WidgetId id;       ///< Идентификатор
+    WidgetKind kind;   ///< Вид
+    UiRect rect;       ///< Положение и размер
+    const char* label; ///< Подпись (пустая для поля ввода)
+};
+
+/**
+ * @class ScreenLayout
+ * @brief Виджеты одного экрана и сеточный индекс для поиска попаданий
+ * 
+ * Экран делится на ячейки фиксированного размера; каждая ячейка хранит
+ * виджеты, которые ее пересекают, поэтому поиск виджета под курсором
+ * проверяет лишь несколько прямоугольников независимо от их числа.
+ * При перекрытии побеждает виджет, объявленный раньше.
+ */
+class ScreenLayout {
+public:
+    /**
+     * @brief Построить индекс для набора виджетов
+     * @param widgets Виджеты в порядке приоритета попадания
+     */
+    explicit ScreenLayout(std::vector<Widget> widgets);
+
+    /**
+     * @brief Виджеты экрана в порядке объявления
+     * @return Список виджетов
+     */
+    const std::vector<Widget>& widgets() const;
+
+    /**
+     * @brief Найти кнопку в точке
+     * @param x Координата x
+     * @param y Координата y
+     * @return Кнопка или nullptr
+     */
+    const Widget* hitTest(int x, int y) const;
+
+private:
+    static const int CELL_SIZE = 50; ///< Размер ячейки индекса в пикселях
+
+    std::vector<Widget> items;                 ///< Виджеты
+    int columns;                               ///< Количество столбцов сетки
+    int rows;                                  ///< Количество строк сетки
+    std::vector<std::vector<uint8_t>> cells;   ///< Индексы кнопок в каждой ячейке
+};
+
+/**
+ * @brief Получить раскладку экрана
+ * @param screen Экран
+ * @return Раскладка
+ */
+const ScreenLayout& screenLayout(Screen screen);
+
+#endif
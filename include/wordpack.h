@@ -0,0 +1,131 @@
+/**
+ * @file wordpack.h
+ * @brief Неизменяемый бинарный набор слов, отображаемый в память через mmap
+ *
+ * Формат файла (числа в порядке байтов машины, записавшей файл; файл с
+ * другим порядком байтов отвергается по полю WordPackHeader::byteOrder):
+ * - WordPackHeader;
+ * - WordPackSection для каждого шифра;
+ * - для каждой секции массив смещений uint32_t[wordCount + 1]
+ *   и следующие за ним буквы всех слов подряд без разделителей.
+ *
+ * Слово i секции занимает байты [offsets[i], offsets[i + 1]) области букв.
+ */
+
+#ifndef WORDPACK_H
+#define WORDPACK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "ciphers.h"
+
+class Database;
+
+/// Сигнатура файла набора слов
+constexpr char WORDPACK_MAGIC[4] = {'A', 'I', 'P', 'W'};
+
+/// Текущая версия формата
+constexpr uint32_t WORDPACK_VERSION = 2;
+
+/// Метка порядка байтов: читается как это значение, только если порядок байтов совпадает
+constexpr uint32_t WORDPACK_BYTE_ORDER = 0x01020304;
+
+/**
+ * @struct WordPackHeader
+ * @brief Заголовок файла набора слов
+ */
+struct WordPackHeader {
+    char magic[4];         ///< Сигнатура WORDPACK_MAGIC
+    uint32_t version;      ///< Версия формата
+    uint32_t sectionCount; ///< Количество секций
+    uint32_t byteOrder;    ///< WORDPACK_BYTE_ORDER в порядке байтов файла
+};
+
+/**
+ * @struct WordPackSection
+ * @brief Описание секции слов одного шифра
+ */
+struct WordPackSection {
+    uint32_t cipher;        ///< Значение CipherType
+    uint32_t wordCount;     ///< Количество слов
+    uint64_t offsetsOffset; ///< Смещение массива смещений от начала файла
+    uint64_t lettersOffset; ///< Смещение области букв от начала файла
+    uint64_t lettersSize;   ///< Размер области букв в байтах
+};
+
+static_assert(sizeof(WordPackHeader) == 16, "WordPackHeader layout");
+static_assert(sizeof(WordPackSection) == 32, "WordPackSection layout");
+
+/**
+ * @class WordPack
+ * @brief Чтение набора слов из файла, отображенного в память
+ *
+ * Слова возвращаются как std::string_view прямо на отображенные байты,
+ * без разбора и копирования.
+ */
+class WordPack {
+public:
+    /**
+     * @brief Отобразить файл набора слов в память
+     * @param pack_path Путь к файлу
+     * @throw std::runtime_error Если файл не открывается или поврежден
+     */
+    explicit WordPack(const std::string& pack_path);
+
+    /**
+     * @brief Деструктор, снимает отображение файла
+     */
+    ~WordPack();
+
+    WordPack(const WordPack&) = delete;
+    WordPack& operator=(const WordPack&) = delete;
+
+    /**
+     * @brief Выгрузить слова из базы данных в файл набора слов
+     * @param db База данных с таблицами шифров
+     * @param pack_path Путь к создаваемому файлу
+     * @throw std::runtime_error Если не удалось записать файл или буквы секции
+     *        не помещаются в 32-битные смещения
+     */
+    static void build(Database& db, const std::string& pack_path);
+
+    /**
+     * @brief Количество слов для шифра
+     * @param cipher Тип шифра
+     * @return Количество слов (0, если секции нет)
+     */
+    size_t wordCount(CipherType cipher) const;
+
+    /**
+     * @brief Получить слово по индексу
+     * @param cipher Тип шифра
+     * @param index Индекс слова
+     * @return Слово, указывающее на отображенную память
+     * @throw std::out_of_range Если индекс вне диапазона
+     */
+    std::string_view word(CipherType cipher, size_t index) const;
+
+    /**
+     * @brief Получить случайное слово для шифра
+     * @param cipher Тип шифра
+     * @return Слово, указывающее на отображенную память
+     * @throw std::runtime_error Если для шифра нет слов
+     */
+    std::string_view randomWord(CipherType cipher) const;
+
+private:
+    const unsigned char* data; ///< Начало отображенного файла
+    size_t size;               ///< Размер файла
+    const WordPackSection* sections[3]; ///< Секции по значению CipherType
+
+    /**
+     * @brief Найти секцию шифра
+     * @param cipher Тип шифра
+     * @return Секция или nullptr
+     */
+    const WordPackSection* section(CipherType cipher) const;
+};
+
+#endif
@@ -0,0 +1,72 @@
+#include "async_database.h"
+#include "trace.h"
+#include <exception>
+#include <utility>
+
+AsyncDatabase::AsyncDatabase(const std::string& db_path, DatabaseMode mode) : stopping(false) {
+    std::promise<void> opened;
+    std::future<void> openResult = opened.get_future();
+    worker = std::thread(&AsyncDatabase::workerLoop, this, db_path, mode, std::move(opened));
+
+    try {
+        openResult.get();
+    } catch (...) {
+        worker.join();
+        throw;
+    }
+}
+
+AsyncDatabase::~AsyncDatabase() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeup.notify_one();
+    worker.join();
+}
+
+void AsyncDatabase::enqueue(std::function<void(Database&)> job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back(std::move(job));
+    }
+    wakeup.notify_one();
+}
+
+void AsyncDatabase::workerLoop(std::string db_path, DatabaseMode mode, std::promise<void> opened) {
+    setTraceThreadName("database");
+    std::unique_ptr<Database> db;
+    try {
+        db = std::make_unique<Database>(db_path, mode);
+        opened.set_value();
+    } catch (...) {
+        opened.set_exception(std::current_exception());
+        return;
+    }
+
+    for (;;) {
+        std::function<void(Database&)> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeup.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                return;
+            }
+            job = std::move(queue.front());
+            queue.pop_front();
+        }
+        job(*db);
+    }
+}
+
+std::future<std::string> AsyncDatabase::getRandomWordAsync(const std::string& table_name) {
+    return submit([table_name](Database& db) { return db.getRandomWord(table_name); });
+}
+
+std::future<Puzzle> AsyncDatabase::getRandomPuzzleAsync(CipherType cipherType) {
+    return submit([cipherType](Database& db) { return db.getRandomPuzzle(cipherType); });
+}
+
+std::future<void> AsyncDatabase::executeAsync(const std::string& sql) {
+    return submit([sql](Database& db) { db.execute(sql); });
+}
@@ -1,15 +1,27 @@
 #include "ciphers.h" 
 #include "database.h"
+#include "memory_tracking.h"
+#include "metrics.h"
+#include "trace.h"
+#include "wordpack.h"
+#include <chrono>
 #include <cstdlib>
 #include <ctime>
+#include <fstream>
 #include <stdexcept>
 #include <memory>
 
 static std::unique_ptr<Database> global_db;
+static std::unique_ptr<WordPack> global_pack;
 
 void initializeDatabase() {
     if (!global_db) {
-        global_db = std::make_unique<Database>("ciphers_database.db");
+        const char* path = "ciphers_database.db";
+        // Образ читается только из готового файла, поэтому при первом запуске файл создается отдельно
+        if (!std::ifstream(path)) {
+            Database disk(path);
+        }
+        global_db = std::make_unique<Database>(path, DatabaseMode::IN_MEMORY);
     }
 }
 
@@ -22,15 +34,57 @@ bool isPrime(int a, int b) {
     return a == 1;
 }
 
+void seedRandom(unsigned seed) {
+    srand(seed);
+}
+
 int randNum(int min, int max) {
     return min + rand() % (max - min + 1);
 }
 
+std::string cipherTableName(CipherType cipherType) {
+    switch (cipherType) {
+        case CipherType::CAESAR: return "caesar_cipher";
+        case CipherType::AFFINE: return "affine_cipher";
+        case CipherType::VIGENERE: return "vigenere_cipher";
+    }
+    throw std::invalid_argument("Unknown cipher type");
+}
+
+void useWordPack(const std::string& pack_path) {
+    global_pack = std::make_unique<WordPack>(pack_path);
+}
+
+static Counter& encryptedBytes() {
+    static Counter& counter = metrics().counter("aip_encrypted_bytes_total", "Bytes passed through the encrypt functions");
+    return counter;
+}
+
+static std::string fetchWord(CipherType cipherType) {
+    if (global_pack) {
+        return std::string(global_pack->randomWord(cipherType));
+    }
+    initializeDatabase();
+    return global_db->getRandomWord(cipherTableName(cipherType));
+}
+
+static std::string getRandomWord(CipherType cipherType) {
+    static Histogram& latency = metrics().histogram("aip_word_fetch_seconds", "Time to fetch a random word",
+                                                    latencyBuckets());
+    auto start = std::chrono::steady_clock::now();
+    std::string word = fetchWord(cipherType);
+    latency.observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    return word;
+}
+
 std::string caesarEncrypt(const std::string& text, int key) {
+    AIP_TRACE_SCOPE("caesarEncrypt");
+    AIP_MEMORY_SCOPE(CIPHER);
+    encryptedBytes().add(text.size());
     std::string result;
     for (char c : text) {
-        if (isalpha(c)) {
-            char base = isupper(c) ? 'A' : 'a';
+        if (isalpha(static_cast<unsigned char>(c))) {
+            char base = isupper(static_cast<unsigned char>(c)) ? 'A' : 'a';
             result += static_cast<char>((c - base + key) % 26 + base);
         } else {
             result += c;
@@ -44,19 +98,21 @@ int generateCaesarKey() {
 }
 
 std::string getRandomCaesarWord() {
-    initializeDatabase();
-    return global_db->getRandomWord("caesar_cipher");
+    return getRandomWord(CipherType::CAESAR);
 }
 
 std::string affineEncrypt(const std::string& text, int a, int b) {
+    AIP_TRACE_SCOPE("affineEncrypt");
+    AIP_MEMORY_SCOPE(CIPHER);
     if (!isPrime(a, 26)) {
         throw std::invalid_argument("a и 26 должны быть взаимно простыми");
     }
-    
+    encryptedBytes().add(text.size());
+
     std::string result;
     for (char c : text) {
-        if (isalpha(c)) {
-            char base = isupper(c) ? 'A' : 'a';
+        if (isalpha(static_cast<unsigned char>(c))) {
+            char base = isupper(static_cast<unsigned char>(c)) ? 'A' : 'a';
             int x = c - base;
             result += static_cast<char>((a * x + b) % 26 + base);
         } else {
@@ -77,18 +133,20 @@ std::pair<int, int> generateAffineKeys() {
 }
 
 std::string getRandomAffineWord() {
-    initializeDatabase();
-    return global_db->getRandomWord("affine_cipher");
+    return getRandomWord(CipherType::AFFINE);
 }
 
 std::string vigenereEncrypt(const std::string& text, const std::string& key) {
+    AIP_TRACE_SCOPE("vigenereEncrypt");
+    AIP_MEMORY_SCOPE(CIPHER);
+    encryptedBytes().add(text.size());
     std::string result;
     for (size_t i = 0; i < text.size(); ++i) {
         char c = text[i];
-        if (isalpha(c)) {
-            char base = isupper(c) ? 'A' : 'a';
+        if (isalpha(static_cast<unsigned char>(c))) {
+            char base = isupper(static_cast<unsigned char>(c)) ? 'A' : 'a';
             char keyChar = key[i % key.size()];
-            int keyShift = toupper(keyChar) - 'A';
+            int keyShift = toupper(static_cast<unsigned char>(keyChar)) - 'A';
             result += static_cast<char>((c - base + keyShift) % 26 + base);
         } else {
             result += c;
@@ -97,16 +155,65 @@ std::string vigenereEncrypt(const std::string& text, const std::string& key) {
     return result;
 }
 
-std::string generateVigenereKey() {
-    const std::vector<std::string> keys = {
+const std::vector<std::string>& vigenereKeys() {
+    static const std::vector<std::string> keys = {
         "FOX", "LIFE", "OIL", "WATER", 
         "CIPHER", "WORK", "RANDOM", "PEN"
     };
+    return keys;
+}
+
+std::string generateVigenereKey() {
+    const std::vector<std::string>& keys = vigenereKeys();
     return keys[randNum(0, keys.size() - 1)];
 }
 
 
 std::string getRandomVigenereWord() {
-    initializeDatabase();
-    return global_db->getRandomWord("vigenere_cipher");
-}
\ No newline at end of file
+    return getRandomWord(CipherType::VIGENERE);
+}
+
+int puzzleDifficulty(const std::string& plaintext) {
+    int letters = 0;
+    for (char c : plaintext) {
+        if (isalpha(static_cast<unsigned char>(c))) ++letters;
+    }
+    if (letters <= 8) return 1;
+    if (letters <= 20) return 2;
+    return 3;
+}
+
+Puzzle generatePuzzle(CipherType cipherType) {
+    AIP_MEMORY_SCOPE(CIPHER);
+    if (!global_pack) {
+        initializeDatabase();
+        if (global_db->hasPuzzles(cipherType)) {
+            return global_db->getRandomPuzzle(cipherType);
+        }
+    }
+
+    Puzzle puzzle;
+    puzzle.cipher = cipherType;
+    puzzle.plaintext = getRandomWord(cipherType);
+    switch (cipherType) {
+        case CipherType::CAESAR: {
+            int key = generateCaesarKey();
+            puzzle.key = std::to_string(key);
+            puzzle.ciphertext = caesarEncrypt(puzzle.plaintext, key);
+            break;
+        }
+        case CipherType::AFFINE: {
+            auto keys = generateAffineKeys();
+            puzzle.key = std::to_string(keys.first) + ", " + std::to_string(keys.second);
+            puzzle.ciphertext = affineEncrypt(puzzle.plaintext, keys.first, keys.second);
+            break;
+        }
+        case CipherType::VIGENERE: {
+            puzzle.key = generateVigenereKey();
+            puzzle.ciphertext = vigenereEncrypt(puzzle.plaintext, puzzle.key);
+            break;
+        }
+    }
+    puzzle.difficulty = puzzleDifficulty(puzzle.plaintext);
+    return puzzle;
+}
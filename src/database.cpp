@@ -1,15 +1,170 @@
 
 #include "database.h"
+#include "ciphers.h"
+#include "memory_tracking.h"
+#include "metrics.h"
+#include "trace.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <iostream>
 #include <stdexcept>
 #include <cstdlib>
 #include <vector>
 #include <utility>
 
-Database::Database(const std::string& db_path) {
+namespace {
+
+void setTextResult(sqlite3_context* context, const std::string& text) {
+    sqlite3_result_text(context, text.data(), static_cast<int>(text.size()), SQLITE_TRANSIENT);
+}
+
+std::string textArgument(sqlite3_value* value) {
+    const unsigned char* text = sqlite3_value_text(value);
+    return std::string(reinterpret_cast<const char*>(text), sqlite3_value_bytes(value));
+}
+
+void caesarFunction(sqlite3_context* context, int, sqlite3_value** argv) {
+    if (sqlite3_value_type(argv[0]) == SQLITE_NULL) {
+        sqlite3_result_null(context);
+        return;
+    }
+    setTextResult(context, caesarEncrypt(textArgument(argv[0]), sqlite3_value_int(argv[1])));
+}
+
+void affineFunction(sqlite3_context* context, int, sqlite3_value** argv) {
+    if (sqlite3_value_type(argv[0]) == SQLITE_NULL) {
+        sqlite3_result_null(context);
+        return;
+    }
+    try {
+        setTextResult(context, affineEncrypt(textArgument(argv[0]),
+                                             sqlite3_value_int(argv[1]), sqlite3_value_int(argv[2])));
+    } catch (const std::exception& e) {
+        sqlite3_result_error(context, e.what(), -1);
+    }
+}
+
+void vigenereFunction(sqlite3_context* context, int, sqlite3_value** argv) {
+    if (sqlite3_value_type(argv[0]) == SQLITE_NULL) {
+        sqlite3_result_null(context);
+        return;
+    }
+    std::string key = textArgument(argv[1]);
+    if (key.empty()) {
+        sqlite3_result_error(context, "vigenere key must not be empty", -1);
+        return;
+    }
+    setTextResult(context, vigenereEncrypt(textArgument(argv[0]), key));
+}
+
+void difficultyFunction(sqlite3_context* context, int, sqlite3_value** argv) {
+    sqlite3_result_int(context, puzzleDifficulty(textArgument(argv[0])));
+}
+
+std::atomic<sqlite3_int64> slowQueryNs{0}; ///< Порог медленного запроса (0 - не выводить)
+
+/// Кэш метрик соединения очищается, если запросов с разным текстом слишком много
+constexpr size_t MAX_CACHED_QUERIES = 256;
+
+/// Сколько случайных id пробуется до перехода к следующей существующей строке
+constexpr int RANDOM_ROW_ATTEMPTS = 16;
+
+/**
+ * @brief Текст запроса без литералов для группировки метрик
+ *
+ * Строки и числа заменяются на ?, пробелы сворачиваются, длина ограничена,
+ * чтобы запросы с разными значениями попадали в одну метрику.
+ */
+std::string normalizeSql(const char* sql) {
+    std::string result;
+    const char* c = sql;
+    while (*c && result.size() < 200) {
+        unsigned char ch = static_cast<unsigned char>(*c);
+        bool afterIdentifier = !result.empty() && (std::isalnum(static_cast<unsigned char>(result.back()))
+                                                   || result.back() == '_');
+        if (std::isspace(ch)) {
+            while (std::isspace(static_cast<unsigned char>(*c))) ++c;
+            if (!result.empty() && *c) result += ' ';
+        } else if (ch == '\'') {
+            for (++c; *c; ++c) {
+                if (*c == '\'' && c[1] == '\'') ++c;
+                else if (*c == '\'') { ++c; break; }
+            }
+            result += '?';
+        } else if (std::isdigit(ch) && !afterIdentifier) {
+            while (std::isalnum(static_cast<unsigned char>(*c)) || *c == '.') ++c;
+            result += '?';
+        } else {
+            result += *c++;
+        }
+    }
+    return result;
+}
+
+sqlite3_int64 randomOffset(sqlite3_int64 span) {
+    if (span <= RAND_MAX) {
+        return randNum(0, static_cast<int>(span - 1));
+    }
+    sqlite3_int64 value = static_cast<sqlite3_int64>(rand()) * (sqlite3_int64(RAND_MAX) + 1) + rand();
+    return value % span;
+}
+
+/**
+ * @brief Выполнить запрос вида "SELECT id, ... WHERE id >= ? ORDER BY id LIMIT 1" для случайного id
+ *
+ * Принимается только строка с выбранным id: следующая за пропуском в id строка
+ * иначе выпадала бы с вероятностью, пропорциональной длине пропуска. Если все
+ * RANDOM_ROW_ATTEMPTS попыток попали в пропуски, берется следующая строка.
+ * @param stmt Подготовленный запрос, первый столбец которого - id
+ * @param param Номер параметра с id
+ * @param first Наименьший id
+ * @param last Наибольший id
+ * @param offset Возвращает случайное смещение от 0 до span - 1
+ * @return Код последнего sqlite3_step
+ */
+int stepRandomRow(sqlite3_stmt* stmt, int param, sqlite3_int64 first, sqlite3_int64 last,
+                  const std::function<sqlite3_int64(sqlite3_int64)>& offset) {
+    int rc = SQLITE_DONE;
+    for (int attempt = 0; attempt < RANDOM_ROW_ATTEMPTS; ++attempt) {
+        sqlite3_int64 id = first + offset(last - first + 1);
+        sqlite3_reset(stmt);
+        sqlite3_bind_int64(stmt, param, id);
+        rc = sqlite3_step(stmt);
+        if (rc != SQLITE_ROW || sqlite3_column_int64(stmt, 0) == id) {
+            break;
+        }
+    }
+    return rc;
+}
+
+}
+
+Database::Database(const std::string& db_path, DatabaseMode mode) : db(nullptr) {
+    if (mode == DatabaseMode::IN_MEMORY) {
+        image = loadImage(db_path);
+        attachImage();
+    } else {
+        openFile(db_path);
+    }
+}
+
+Database::Database(std::shared_ptr<const DatabaseImage> image) : db(nullptr), image(std::move(image)) {
+    attachImage();
+}
+
+Database::~Database() {
+    sqlite3_close(db);
+}
+
+void Database::openFile(const std::string& db_path) {
+    AIP_MEMORY_SCOPE(DATABASE);
     int rc = sqlite3_open(db_path.c_str(), &db);
     if (rc != SQLITE_OK) {
         throw std::runtime_error("Cannot open database: " + std::string(sqlite3_errmsg(db)));
     }
+    registerCipherFunctions();
+    installProfiler();
 
 
     const char* createTablesSQL = 
@@ -36,8 +191,148 @@ Database::Database(const std::string& db_path) {
     fillTestDataIfEmpty();
 }
 
-Database::~Database() {
-    sqlite3_close(db);
+void Database::attachImage() {
+    AIP_MEMORY_SCOPE(DATABASE);
+    if (!image || image->empty()) {
+        throw std::runtime_error("Cannot open database: empty in-memory image");
+    }
+
+    int rc = sqlite3_open(":memory:", &db);
+    if (rc != SQLITE_OK) {
+        throw std::runtime_error("Cannot open database: " + std::string(sqlite3_errmsg(db)));
+    }
+
+    // В режиме READONLY без FREEONCLOSE SQLite читает буфер напрямую и не
+    // изменяет его, поэтому один образ могут разделять несколько соединений.
+    unsigned char* data = const_cast<unsigned char*>(image->data());
+    sqlite3_int64 size = static_cast<sqlite3_int64>(image->size());
+    rc = sqlite3_deserialize(db, "main", data, size, size, SQLITE_DESERIALIZE_READONLY);
+    checkError(rc, "Failed to load in-memory image");
+    registerCipherFunctions();
+    installProfiler();
+}
+
+void Database::registerCipherFunctions() {
+    const int flags = SQLITE_UTF8 | SQLITE_DETERMINISTIC;
+    int rc = sqlite3_create_function(db, "caesar", 2, flags, nullptr, caesarFunction, nullptr, nullptr);
+    checkError(rc, "Failed to register caesar()");
+    rc = sqlite3_create_function(db, "affine", 3, flags, nullptr, affineFunction, nullptr, nullptr);
+    checkError(rc, "Failed to register affine()");
+    rc = sqlite3_create_function(db, "vigenere", 2, flags, nullptr, vigenereFunction, nullptr, nullptr);
+    checkError(rc, "Failed to register vigenere()");
+    rc = sqlite3_create_function(db, "difficulty", 1, flags, nullptr, difficultyFunction, nullptr, nullptr);
+    checkError(rc, "Failed to register difficulty()");
+}
+
+void Database::installProfiler() {
+    int rc = sqlite3_trace_v2(db, SQLITE_TRACE_STMT | SQLITE_TRACE_ROW | SQLITE_TRACE_PROFILE, profileCallback, this);
+    checkError(rc, "Failed to install query profiler");
+}
+
+int Database::profileCallback(unsigned type, void* context, void* p, void* x) {
+    Database* self = static_cast<Database*>(context);
+    sqlite3_stmt* stmt = static_cast<sqlite3_stmt*>(p);
+    // Одновременно выполняются обычно один-два запроса, поэтому поиск линейный
+    auto running = std::find_if(self->runningQueries.begin(), self->runningQueries.end(),
+                                [stmt](const RunningQuery& query) { return query.stmt == stmt; });
+
+    if (type == SQLITE_TRACE_STMT) {
+        // Триггеры сообщают о себе комментарием "--" в рамках уже начатого запроса
+        const char* text = static_cast<const char*>(x);
+        if (running == self->runningQueries.end()) {
+            self->runningQueries.push_back({stmt, std::chrono::steady_clock::now(), 0});
+        } else if (!text || text[0] != '-' || text[1] != '-') {
+            *running = {stmt, std::chrono::steady_clock::now(), 0};
+        }
+    } else if (type == SQLITE_TRACE_ROW) {
+        if (running != self->runningQueries.end()) {
+            ++running->rows;
+        }
+    } else if (type == SQLITE_TRACE_PROFILE) {
+        // Время SQLite округлено до миллисекунд, поэтому замеряется свое
+        if (running != self->runningQueries.end()) {
+            self->queryFinished(stmt);
+        }
+    }
+    return 0;
+}
+
+void Database::queryFinished(sqlite3_stmt* stmt) {
+    auto running = std::find_if(runningQueries.begin(), runningQueries.end(),
+                                [stmt](const RunningQuery& query) { return query.stmt == stmt; });
+    sqlite3_int64 nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - running->start).count();
+    uint64_t rows = running->rows;
+    runningQueries.erase(running);
+
+    // Счетчики сбрасываются, чтобы следующее выполнение того же запроса считалось отдельно
+    int fullScanSteps = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_FULLSCAN_STEP, 1);
+    int sorts = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_SORT, 1);
+
+    const char* text = sqlite3_sql(stmt);
+    std::string sql = text ? text : "";
+    auto cached = queryMetrics.find(sql);
+    if (cached == queryMetrics.end()) {
+        if (queryMetrics.size() >= MAX_CACHED_QUERIES) {
+            queryMetrics.clear();
+        }
+        QueryMetrics entry;
+        entry.sql = normalizeSql(sql.c_str());
+        MetricLabels labels = {{"sql", entry.sql}};
+        MetricsRegistry& registry = metrics();
+        entry.seconds = &registry.histogram("aip_sql_seconds", "SQLite statement wall time", latencyBuckets(), labels);
+        entry.rows = &registry.counter("aip_sql_rows_total", "Rows returned by SQLite statements", labels);
+        entry.fullScanSteps = &registry.counter("aip_sql_fullscan_steps_total",
+                                                "Full table scan steps taken by SQLite statements", labels);
+        entry.sorts = &registry.counter("aip_sql_sorts_total", "Sort operations run by SQLite statements", labels);
+        cached = queryMetrics.emplace(sql, std::move(entry)).first;
+    }
+
+    const QueryMetrics& query = cached->second;
+    query.seconds->observe(nanoseconds / 1e9);
+    query.rows->add(rows);
+    query.fullScanSteps->add(static_cast<uint64_t>(fullScanSteps));
+    query.sorts->add(static_cast<uint64_t>(sorts));
+
+    sqlite3_int64 threshold = slowQueryNs.load(std::memory_order_relaxed);
+    if (threshold > 0 && nanoseconds >= threshold) {
+        std::cerr << "Slow query " << nanoseconds / 1e6 << " ms (" << rows << " rows, " << fullScanSteps
+                  << " full scan steps, " << sorts << " sorts): " << query.sql << std::endl;
+    }
+}
+
+void Database::setSlowQueryThreshold(std::chrono::microseconds threshold) {
+    slowQueryNs.store(static_cast<sqlite3_int64>(threshold.count()) * 1000, std::memory_order_relaxed);
+}
+
+std::shared_ptr<const DatabaseImage> Database::loadImage(const std::string& db_path) {
+    AIP_MEMORY_SCOPE(DATABASE);
+    // Образ - снимок готового файла: без создания файла, таблиц и тестовых данных
+    sqlite3* source = nullptr;
+    int rc = sqlite3_open_v2(db_path.c_str(), &source, SQLITE_OPEN_READONLY, nullptr);
+    if (rc != SQLITE_OK) {
+        std::string error = "Cannot open database " + db_path + ": " + sqlite3_errmsg(source);
+        sqlite3_close(source);
+        throw std::runtime_error(error);
+    }
+
+    sqlite3_int64 size = 0;
+    unsigned char* data = sqlite3_serialize(source, "main", &size, 0);
+    sqlite3_close(source);
+    if (!data) {
+        throw std::runtime_error("Failed to serialize database " + db_path);
+    }
+
+    auto result = std::make_shared<DatabaseImage>(data, data + size);
+    sqlite3_free(data);
+
+    // Образ в памяти не может работать в режиме WAL: переводим заголовок
+    // файла (версии записи и чтения) в режим журнала отката.
+    if (result->size() > 19) {
+        (*result)[18] = 1;
+        (*result)[19] = 1;
+    }
+    return result;
 }
 
 void Database::checkError(int rc, const char* error_msg) {
@@ -84,20 +379,227 @@ void Database::fillTestDataIfEmpty() {
 }
 
 std::string Database::getRandomWord(const std::string& table_name) {
-    std::string sql = "SELECT word FROM " + table_name + " ORDER BY RANDOM() LIMIT 1;";
-    
+    AIP_TRACE_SCOPE("Database::getRandomWord");
+    // Слово выбирается по rowid из rand(), а не через ORDER BY RANDOM(),
+    // чтобы seedRandom делал выбор воспроизводимым
+    return selectWord(table_name, randomOffset);
+}
+
+std::string Database::getRandomWord(const std::string& table_name, std::mt19937& rng) {
+    AIP_TRACE_SCOPE("Database::getRandomWord");
+    return selectWord(table_name, [&rng](sqlite3_int64 span) {
+        return std::uniform_int_distribution<sqlite3_int64>(0, span - 1)(rng);
+    });
+}
+
+std::string Database::selectWord(const std::string& table_name,
+                                 const std::function<sqlite3_int64(sqlite3_int64)>& offset) {
+    AIP_MEMORY_SCOPE(DATABASE);
+    std::string sql = "SELECT rowid, word FROM " + table_name + " WHERE rowid >= ? ORDER BY rowid LIMIT 1;";
     sqlite3_stmt* stmt;
     int rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr);
     checkError(rc, "Failed to prepare statement");
-    
-    rc = sqlite3_step(stmt);
+
+    rc = SQLITE_DONE;
+    // Кэш диапазона может устареть, если таблицу изменили не через execute: тогда он читается заново
+    for (int attempt = 0; attempt < 2 && rc != SQLITE_ROW; ++attempt) {
+        if (attempt > 0) {
+            wordRanges.erase(table_name);
+        }
+        const IdRange& range = wordRange(table_name);
+        if (range.last < range.first) {
+            continue;
+        }
+        rc = stepRandomRow(stmt, 1, range.first, range.last, offset);
+    }
     if (rc != SQLITE_ROW) {
         sqlite3_finalize(stmt);
         throw std::runtime_error("No words found in table " + table_name);
     }
     
-    std::string word = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+    std::string word = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
     sqlite3_finalize(stmt);
     
     return word;
-}
\ No newline at end of file
+}
+
+std::vector<std::string> Database::getAllWords(const std::string& table_name) {
+    AIP_MEMORY_SCOPE(DATABASE);
+    std::string sql = "SELECT word FROM " + table_name + " ORDER BY id;";
+
+    sqlite3_stmt* stmt;
+    int rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr);
+    checkError(rc, "Failed to prepare statement");
+
+    std::vector<std::string> words;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        words.emplace_back(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)));
+    }
+    sqlite3_finalize(stmt);
+
+    if (rc != SQLITE_DONE) {
+        throw std::runtime_error("Failed to read words from table " + table_name);
+    }
+    return words;
+}
+
+void Database::execute(const std::string& sql) {
+    AIP_MEMORY_SCOPE(DATABASE);
+    wordRanges.clear();
+    char* errMsg = nullptr;
+    int rc = sqlite3_exec(db, sql.c_str(), nullptr, nullptr, &errMsg);
+    if (rc != SQLITE_OK) {
+        std::string error = "Failed to execute SQL: " + std::string(errMsg ? errMsg : sqlite3_errmsg(db));
+        sqlite3_free(errMsg);
+        throw std::runtime_error(error);
+    }
+}
+
+void Database::buildPuzzles() {
+    execute(
+        "CREATE TABLE IF NOT EXISTS puzzles ("
+        "id INTEGER PRIMARY KEY,"
+        "word_id INTEGER NOT NULL,"
+        "cipher INTEGER NOT NULL,"
+        "key TEXT NOT NULL,"
+        "ciphertext TEXT NOT NULL,"
+        "difficulty INTEGER NOT NULL);"
+        "CREATE INDEX IF NOT EXISTS puzzles_cipher ON puzzles (cipher);"
+        "CREATE TEMP TABLE IF NOT EXISTS puzzle_keys ("
+        "cipher INTEGER NOT NULL, key TEXT NOT NULL, a INTEGER, b INTEGER);");
+
+    execute("BEGIN;");
+    try {
+        execute("DELETE FROM puzzles; DELETE FROM temp.puzzle_keys;");
+
+        sqlite3_stmt* stmt;
+        int rc = sqlite3_prepare_v2(db, "INSERT INTO temp.puzzle_keys VALUES (?, ?, ?, ?);", -1, &stmt, nullptr);
+        checkError(rc, "Failed to prepare statement");
+        auto addKey = [&](CipherType cipher, const std::string& key, int a, int b) {
+            sqlite3_bind_int(stmt, 1, static_cast<int>(cipher));
+            sqlite3_bind_text(stmt, 2, key.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_bind_int(stmt, 3, a);
+            sqlite3_bind_int(stmt, 4, b);
+            int stepRc = sqlite3_step(stmt);
+            sqlite3_reset(stmt);
+            if (stepRc != SQLITE_DONE) {
+                sqlite3_finalize(stmt);
+                checkError(stepRc, "Failed to insert puzzle key");
+            }
+        };
+        for (int key = 1; key <= 25; ++key) {
+            addKey(CipherType::CAESAR, std::to_string(key), key, 0);
+        }
+        for (int a = 1; a <= 25; ++a) {
+            if (!isPrime(a, 26)) continue;
+            for (int b = 0; b <= 25; ++b) {
+                addKey(CipherType::AFFINE, std::to_string(a) + ", " + std::to_string(b), a, b);
+            }
+        }
+        for (const auto& key : vigenereKeys()) {
+            addKey(CipherType::VIGENERE, key, 0, 0);
+        }
+        sqlite3_finalize(stmt);
+
+        const std::pair<CipherType, const char*> generators[] = {
+            {CipherType::CAESAR, "caesar(w.word, k.a)"},
+            {CipherType::AFFINE, "affine(w.word, k.a, k.b)"},
+            {CipherType::VIGENERE, "vigenere(w.word, k.key)"}
+        };
+        for (const auto& [cipher, encrypt] : generators) {
+            std::string type = std::to_string(static_cast<int>(cipher));
+            execute("INSERT INTO puzzles (word_id, cipher, key, ciphertext, difficulty) "
+                    "SELECT w.id, " + type + ", k.key, " + encrypt + ", difficulty(w.word) "
+                    "FROM " + cipherTableName(cipher) + " w "
+                    "JOIN temp.puzzle_keys k ON k.cipher = " + type + " "
+                    "ORDER BY w.id, k.rowid;");
+        }
+        execute("COMMIT;");
+    } catch (...) {
+        sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        throw;
+    }
+
+    for (auto& range : puzzleRanges) {
+        range = IdRange();
+    }
+}
+
+const Database::IdRange& Database::puzzleRange(CipherType cipherType) {
+    IdRange& range = puzzleRanges[static_cast<int>(cipherType)];
+    if (range.known) {
+        return range;
+    }
+
+    sqlite3_stmt* stmt;
+    int rc = sqlite3_prepare_v2(db, "SELECT min(id), max(id) FROM puzzles WHERE cipher = ?;", -1, &stmt, nullptr);
+    if (rc == SQLITE_OK) {
+        sqlite3_bind_int(stmt, 1, static_cast<int>(cipherType));
+        if (sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_type(stmt, 0) != SQLITE_NULL) {
+            range.first = sqlite3_column_int64(stmt, 0);
+            range.last = sqlite3_column_int64(stmt, 1);
+        }
+    }
+    // Если таблицы puzzles нет, головоломок для шифра тоже нет
+    sqlite3_finalize(stmt);
+    range.known = true;
+    return range;
+}
+
+const Database::IdRange& Database::wordRange(const std::string& table_name) {
+    IdRange& range = wordRanges[table_name];
+    if (range.known) {
+        return range;
+    }
+
+    // min и max по rowid - один поиск по B-дереву, а не просмотр таблицы
+    std::string sql = "SELECT min(rowid), max(rowid) FROM " + table_name + ";";
+    sqlite3_stmt* stmt;
+    int rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr);
+    checkError(rc, "Failed to prepare statement");
+    if (sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_type(stmt, 0) != SQLITE_NULL) {
+        range.first = sqlite3_column_int64(stmt, 0);
+        range.last = sqlite3_column_int64(stmt, 1);
+    }
+    sqlite3_finalize(stmt);
+    range.known = true;
+    return range;
+}
+
+bool Database::hasPuzzles(CipherType cipherType) {
+    const IdRange& range = puzzleRange(cipherType);
+    return range.last >= range.first;
+}
+
+Puzzle Database::getRandomPuzzle(CipherType cipherType) {
+    AIP_MEMORY_SCOPE(DATABASE);
+    const IdRange& range = puzzleRange(cipherType);
+    if (range.last < range.first) {
+        throw std::runtime_error("No puzzles found for table " + cipherTableName(cipherType));
+    }
+
+    std::string sql = "SELECT p.id, w.word, p.key, p.ciphertext, p.difficulty "
+                      "FROM puzzles p JOIN " + cipherTableName(cipherType) + " w ON w.id = p.word_id "
+                      "WHERE p.cipher = ? AND p.id >= ? ORDER BY p.id LIMIT 1;";
+
+    sqlite3_stmt* stmt;
+    int rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr);
+    checkError(rc, "Failed to prepare statement");
+
+    sqlite3_bind_int(stmt, 1, static_cast<int>(cipherType));
+    rc = stepRandomRow(stmt, 2, range.first, range.last, randomOffset);
+    if (rc != SQLITE_ROW) {
+        sqlite3_finalize(stmt);
+        throw std::runtime_error("No puzzles found for table " + cipherTableName(cipherType));
+    }
+
+    Puzzle puzzle;
+    puzzle.cipher = cipherType;
+    puzzle.plaintext = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+    puzzle.key = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
+    puzzle.ciphertext = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
+    puzzle.difficulty = sqlite3_column_int(stmt, 4);
+    sqlite3_finalize(stmt);
+
+    return puzzle;
+}
@@ -0,0 +1,95 @@
+#include "font_manager.h"
+#include "metrics.h"
+#include <fstream>
+#include <iterator>
+
+namespace {
+
+Counter& filesRead() {
+    static Counter& counter = metrics().counter("aip_font_files_read_total", "Font files read from disk");
+    return counter;
+}
+
+Counter& bytesInMemory() {
+    static Counter& counter = metrics().counter("aip_font_bytes_loaded_total", "Font file bytes loaded into memory");
+    return counter;
+}
+
+Counter& fontsOpened() {
+    static Counter& counter = metrics().counter("aip_fonts_opened_total", "Font (path, size) pairs opened");
+    return counter;
+}
+
+Counter& cacheHits() {
+    static Counter& counter = metrics().counter("aip_font_cache_hits_total", "Font requests served from the cache");
+    return counter;
+}
+
+Histogram& loadLatency() {
+    static Histogram& histogram = metrics().histogram("aip_font_load_seconds", "Time to read a font file and open a font",
+                                                      latencyBuckets());
+    return histogram;
+}
+
+}
+
+FontManager::FontManager(bool keepFilesInMemory) : keepFilesInMemory(keepFilesInMemory) {}
+
+FontManager::~FontManager() {
+    for (auto& [key, font] : fonts) {
+        TTF_CloseFont(font);
+    }
+}
+
+const FontStats& FontManager::stats() const {
+    return statistics;
+}
+
+TTF_Font* FontManager::get(const std::string& path, int size) {
+    auto it = fonts.find({path, size});
+    if (it != fonts.end()) {
+        ++statistics.cacheHits;
+        cacheHits().add();
+        return it->second;
+    }
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    TTF_Font* font = open(path, size);
+    double seconds = static_cast<double>(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+    statistics.loadMilliseconds += seconds * 1000.0;
+    loadLatency().observe(seconds);
+
+    if (font) {
+        ++statistics.fontsOpened;
+        fontsOpened().add();
+        fonts.emplace(std::make_pair(path, size), font);
+    }
+    return font;
+}
+
+TTF_Font* FontManager::open(const std::string& path, int size) {
+    if (!keepFilesInMemory) {
+        ++statistics.filesRead;
+        filesRead().add();
+        return TTF_OpenFont(path.c_str(), size);
+    }
+
+    auto file = files.find(path);
+    if (file == files.end()) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            SDL_SetError("Couldn't open %s", path.c_str());
+            return nullptr;
+        }
+        std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        ++statistics.filesRead;
+        statistics.bytesInMemory += bytes.size();
+        filesRead().add();
+        bytesInMemory().add(bytes.size());
+        file = files.emplace(path, std::move(bytes)).first;
+    }
+
+    // Буфер живет до деструктора менеджера, поэтому закрывать RWops должен шрифт
+    SDL_RWops* rw = SDL_RWFromConstMem(file->second.data(), static_cast<int>(file->second.size()));
+    return rw ? TTF_OpenFontRW(rw, 1, size) : nullptr;
+}
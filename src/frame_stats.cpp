@@ -0,0 +1,125 @@
+#include "frame_stats.h"
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+
+namespace {
+
+const size_t STAGE_COUNT = static_cast<size_t>(FrameStage::COUNT);
+
+double percentile(std::vector<double>& sorted, double fraction) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t index = static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5);
+    return sorted[index];
+}
+
+std::string format(const char* pattern, double a, double b = 0, double c = 0, double d = 0) {
+    char buffer[128];
+    std::snprintf(buffer, sizeof(buffer), pattern, a, b, c, d);
+    return buffer;
+}
+
+}
+
+const char* frameStageName(FrameStage stage) {
+    switch (stage) {
+        case FrameStage::EVENTS: return "events";
+        case FrameStage::RENDER: return "render";
+        case FrameStage::DATABASE: return "database";
+        case FrameStage::COUNT: break;
+    }
+    return "unknown";
+}
+
+FrameStats::FrameStats(size_t capacity) : samples(std::max<size_t>(capacity, 1)), nextIndex(0), count(0) {}
+
+void FrameStats::addFrame(const FrameSample& sample) {
+    samples[nextIndex] = sample;
+    nextIndex = (nextIndex + 1) % samples.size();
+    count = std::min(count + 1, samples.size());
+}
+
+FrameSummary FrameStats::summary() const {
+    FrameSummary result;
+    result.frames = count;
+    if (count == 0) {
+        return result;
+    }
+
+    std::vector<double> times;
+    times.reserve(count);
+    double totalIntervalMs = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const FrameSample& sample = samples[i];
+        times.push_back(sample.frameMs);
+        totalIntervalMs += sample.intervalMs;
+        for (size_t stage = 0; stage < STAGE_COUNT; ++stage) {
+            result.stageMs[stage] += sample.stageMs[stage];
+        }
+        result.drawCalls += sample.drawCalls;
+        result.vertices += sample.vertices;
+        result.texturesCreated += sample.texturesCreated;
+        result.texturesDestroyed += sample.texturesDestroyed;
+        result.textureUploads += sample.textureUploads;
+        result.allocations += sample.allocations;
+        result.allocatedBytes += sample.allocatedBytes;
+    }
+
+    std::sort(times.begin(), times.end());
+    result.p50Ms = percentile(times, 0.50);
+    result.p95Ms = percentile(times, 0.95);
+    result.p99Ms = percentile(times, 0.99);
+    result.maxMs = times.back();
+    result.fps = totalIntervalMs > 0 ? count * 1000.0 / totalIntervalMs : 0;
+
+    for (double& stage : result.stageMs) {
+        stage /= count;
+    }
+    result.drawCalls /= count;
+    result.vertices /= count;
+    result.texturesCreated /= count;
+    result.texturesDestroyed /= count;
+    result.textureUploads /= count;
+    result.allocations /= count;
+    result.allocatedBytes /= count;
+    return result;
+}
+
+std::vector<std::string> FrameStats::overlayLines() const {
+    FrameSummary s = summary();
+    std::vector<std::string> lines;
+    lines.push_back(format("%.0f FPS  frame p50 %.2f  p95 %.2f  p99 %.2f ms", s.fps, s.p50Ms, s.p95Ms, s.p99Ms));
+    lines.push_back(format("events %.3f  render %.3f  db %.3f ms/frame",
+                           s.stageMs[static_cast<size_t>(FrameStage::EVENTS)],
+                           s.stageMs[static_cast<size_t>(FrameStage::RENDER)],
+                           s.stageMs[static_cast<size_t>(FrameStage::DATABASE)]));
+    lines.push_back(format("draw calls %.1f  vertices %.0f  allocs %.1f (%.0f B)/frame", s.drawCalls, s.vertices,
+                           s.allocations, s.allocatedBytes));
+    lines.push_back(format("textures +%.2f -%.2f  uploads %.2f /frame", s.texturesCreated, s.texturesDestroyed,
+                           s.textureUploads));
+    return lines;
+}
+
+std::string FrameStats::toJson() const {
+    FrameSummary s = summary();
+    std::ostringstream out;
+    out << "{\"frames\": " << s.frames
+        << ", \"fps\": " << s.fps
+        << ", \"frame_ms\": {\"p50\": " << s.p50Ms << ", \"p95\": " << s.p95Ms
+        << ", \"p99\": " << s.p99Ms << ", \"max\": " << s.maxMs << "}"
+        << ", \"stage_ms\": {";
+    for (size_t stage = 0; stage < STAGE_COUNT; ++stage) {
+        out << (stage ? ", " : "") << "\"" << frameStageName(static_cast<FrameStage>(stage)) << "\": "
+            << s.stageMs[stage];
+    }
+    out << "}, \"draw_calls\": " << s.drawCalls
+        << ", \"vertices\": " << s.vertices
+        << ", \"textures_created\": " << s.texturesCreated
+        << ", \"textures_destroyed\": " << s.texturesDestroyed
+        << ", \"texture_uploads\": " << s.textureUploads
+        << ", \"allocations\": " << s.allocations
+        << ", \"allocated_bytes\": " << s.allocatedBytes << "}";
+    return out.str();
+}
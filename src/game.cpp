@@ -1,10 +1,117 @@
 #include "game.h"
+#include "trace.h"
+#include <chrono>
+#include <fstream>
+#include <ctime>
 #include <iostream>
+#include <stdexcept>
 
+namespace {
 
-Game::Game() : window(nullptr), renderer(nullptr), font(nullptr), running(true),
-               showHint1(false), showHint2(false), gameWon(false) {
-    initSDL();
+Histogram& frameTimes() {
+    static Histogram& histogram = metrics().histogram("aip_frame_seconds", "Time to build and present a frame",
+                                                      latencyBuckets());
+    return histogram;
+}
+
+bool toRecordedEvent(const SDL_Event& e, RecordedEvent& recorded) {
+    switch (e.type) {
+        case SDL_QUIT:
+            recorded.type = RecordedEventType::QUIT;
+            return true;
+        case SDL_KEYDOWN:
+            recorded.type = RecordedEventType::KEY_DOWN;
+            recorded.code = e.key.keysym.sym;
+            return true;
+        case SDL_TEXTINPUT:
+            recorded.type = RecordedEventType::TEXT_INPUT;
+            recorded.text = e.text.text;
+            return true;
+        case SDL_MOUSEBUTTONDOWN:
+            recorded.type = RecordedEventType::MOUSE_DOWN;
+            recorded.x = e.button.x;
+            recorded.y = e.button.y;
+            return true;
+        case SDL_WINDOWEVENT:
+            recorded.type = RecordedEventType::WINDOW;
+            recorded.code = e.window.event;
+            return true;
+    }
+    return false;
+}
+
+SDL_Event toSdlEvent(const RecordedEvent& recorded) {
+    SDL_Event e{};
+    switch (recorded.type) {
+        case RecordedEventType::QUIT:
+            e.type = SDL_QUIT;
+            break;
+        case RecordedEventType::KEY_DOWN:
+            e.type = SDL_KEYDOWN;
+            e.key.keysym.sym = recorded.code;
+            break;
+        case RecordedEventType::TEXT_INPUT:
+            e.type = SDL_TEXTINPUT;
+            recorded.text.copy(e.text.text, sizeof(e.text.text) - 1);
+            break;
+        case RecordedEventType::MOUSE_DOWN:
+            e.type = SDL_MOUSEBUTTONDOWN;
+            e.button.x = recorded.x;
+            e.button.y = recorded.y;
+            break;
+        case RecordedEventType::WINDOW:
+            e.type = SDL_WINDOWEVENT;
+            e.window.event = static_cast<Uint8>(recorded.code);
+            break;
+    }
+    return e;
+}
+
+}
+
+Game::Game(const GameOptions& options) : options(options), window(nullptr),
+               core([this](CipherType type) {
+                   Uint64 start = SDL_GetPerformanceCounter();
+                   Puzzle puzzle = prefetcher->next(type);
+                   addStageTime(FrameStage::DATABASE, start);
+                   return puzzle;
+               }),
+               drawnRevision(~uint64_t(0)),
+               needsRedraw(true), running(true), publishedRevision(~uint64_t(0)),
+               renderSignal(false), stopRendering(false), lastPresent(0), overlayUpdated(0), showStats(false),
+               recordStart(0) {
+    for (auto& ticks : stageTicks) {
+        ticks = 0;
+    }
+    if (!options.traceFile.empty()) {
+        setTraceThreadName("main");
+        setTracingEnabled(true);
+    }
+    initInputRecording();
+    if (!options.metricsFile.empty()) {
+        metricsWriter = std::make_unique<MetricsWriter>(metrics(), options.metricsFile,
+                                                        std::chrono::milliseconds(options.metricsIntervalMs));
+    }
+    prefetcher = std::make_unique<PuzzlePrefetcher>();
+    try {
+        initSDL();
+    } catch (...) {
+        // Деструктор не вызовется: SDL освобождается здесь, а потоки остановят деструкторы членов
+        cleanup();
+        throw;
+    }
+    framedMemory = totalMemoryUsage();
+}
+
+void Game::initInputRecording() {
+    if (!options.replayFile.empty()) {
+        replayInput = InputRecording::load(options.replayFile);
+        seedRandom(replayInput.seed);
+    } else if (!options.recordFile.empty()) {
+        uint32_t seed = options.randomSeed ? options.randomSeed : static_cast<uint32_t>(time(nullptr));
+        seedRandom(seed);
+        recorder = std::make_unique<InputRecorder>(options.recordFile, seed);
+    }
 }
 
 Game::~Game() {
@@ -12,426 +119,364 @@ Game::~Game() {
 }
 
 void Game::initSDL() {
+#ifdef AIP_MEMORY_TRACKING
+    // До любых вызовов SDL, чтобы вся память SDL проходила через учет
+    SDL_SetMemoryFunctions(trackedMalloc, trackedCalloc, trackedRealloc, trackedFree);
+#endif
+    if (options.headless) {
+        SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+    }
     if (SDL_Init(SDL_INIT_VIDEO) < 0) {
-        std::cerr << "SDL could not initialize! SDL_Error: " << SDL_GetError() << std::endl;
-        exit(1);
+        throw std::runtime_error(std::string("SDL could not initialize! SDL_Error: ") + SDL_GetError());
     }
 
     if (TTF_Init() == -1) {
-        std::cerr << "TTF could not initialize! TTF_Error: " << TTF_GetError() << std::endl;
-        exit(1);
+        throw std::runtime_error(std::string("TTF could not initialize! TTF_Error: ") + TTF_GetError());
     }
 
+    // Воспроизведение выводит кадры в скрытое окно
+    bool offscreen = options.headless || !options.replayFile.empty();
     window = SDL_CreateWindow("Cipher Game", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
-                              800, 600, SDL_WINDOW_SHOWN);
+                              800, 600, offscreen ? SDL_WINDOW_HIDDEN : SDL_WINDOW_SHOWN);
     if (!window) {
-        std::cerr << "Window could not be created! SDL_Error: " << SDL_GetError() << std::endl;
-        exit(1);
-    }
-
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
-    if (!renderer) {
-        std::cerr << "Renderer could not be created! SDL_Error: " << SDL_GetError() << std::endl;
-        exit(1);
+        throw std::runtime_error(std::string("Window could not be created! SDL_Error: ") + SDL_GetError());
     }
 
-    font = TTF_OpenFont("NotoSans-Regular.ttf", 24);
-    if (!font) {
-        std::cerr << "Failed to load font! TTF_Error: " << TTF_GetError() << std::endl;
-        exit(1);
+    // В многопоточном режиме рендерер создается в потоке отрисовки
+    if (!options.renderThread) {
+        view = std::make_unique<GameView>(window, options.vsync, options.headless);
     }
 }
 
 void Game::cleanup() {
-    if (font) TTF_CloseFont(font);
-    if (renderer) SDL_DestroyRenderer(renderer);
+    stopRenderThread();
+    view.reset();
     if (window) SDL_DestroyWindow(window);
     TTF_Quit();
     SDL_Quit();
 }
 
 void Game::run() {
+    recordStart = SDL_GetTicks();
+    if (!options.replayFile.empty()) {
+        runReplay();
+    } else if (options.renderThread) {
+        runThreaded();
+    } else if (options.eventDriven) {
+        runEventDriven();
+    } else {
+        runPolling();
+    }
+    writeStats();
+    writeTrace();
+}
+
+void Game::writeTrace() const {
+    if (options.traceFile.empty()) {
+        return;
+    }
+    try {
+        writeTraceFile(options.traceFile);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+    }
+}
+
+void Game::writeStats() const {
+    if (!options.statsFile.empty()) {
+        std::ofstream out(options.statsFile);
+        out << frameStats.toJson() << std::endl;
+        if (!out) {
+            std::cerr << "Failed to write frame statistics to " << options.statsFile << std::endl;
+        }
+    }
+
+    if (!options.memoryFile.empty()) {
+        std::ofstream out(options.memoryFile);
+        out << memoryUsageJson() << std::endl;
+        if (!out) {
+            std::cerr << "Failed to write memory usage to " << options.memoryFile << std::endl;
+        }
+    }
+
+    // Одна строка на сессию, чтобы файл накапливал историю запусков
+    if (!options.latencyFile.empty()) {
+        std::ofstream out(options.latencyFile, std::ios::app);
+        out << latency.toJson() << std::endl;
+        if (!out) {
+            std::cerr << "Failed to write input latency to " << options.latencyFile << std::endl;
+        }
+    }
+}
+
+void Game::runPolling() {
     while (running) {
         handleEvents();
         render();
-        SDL_Delay(16);
+        if (!options.vsync) {
+            SDL_Delay(16);
+        }
     }
 }
 
-void Game::handleEvents() {
-    SDL_Event e;
-    while (SDL_PollEvent(&e)) {
-        if (e.type == SDL_QUIT) {
-            running = false;
+void Game::runEventDriven() {
+    Uint32 nextTick = SDL_GetTicks() + options.animationIntervalMs;
+    while (running) {
+        if (needsRedraw || drawnRevision != core.revision()) {
+            render();
         }
-        else if (e.type == SDL_KEYDOWN) {
-            if (e.key.keysym.sym == SDLK_ESCAPE) {
-                running = false;
-            }
-            else if (e.key.keysym.sym == SDLK_RETURN) {
-                checkAnswer();
-            }
-            else if (e.key.keysym.sym == SDLK_BACKSPACE && !gameWon) {
-                if (!userInput.empty()) {
-                    userInput.pop_back();
-                }
-            }
+
+        // Без анимации поток спит в SDL до прихода события
+        int timeout = -1;
+        if (options.animationIntervalMs > 0) {
+            Sint32 remaining = static_cast<Sint32>(nextTick - SDL_GetTicks());
+            timeout = remaining > 0 ? remaining : 0;
         }
-        else if (e.type == SDL_TEXTINPUT && !gameWon) {
-            userInput += e.text.text;
+
+        SDL_Event e;
+        if (SDL_WaitEventTimeout(&e, timeout)) {
+            handleEvent(e);
+            handleEvents();
         }
-        else if (e.type == SDL_MOUSEBUTTONDOWN) {
-            int x, y;
-            SDL_GetMouseState(&x, &y);
-
-            if (gameWon) {
-
-                if (x >= 200 && x <= 400 && y >= 400 && y <= 460) {
-                    showCipherScreen(currentCipher);
-                }
-
-                else if (x >= 400 && x <= 600 && y >= 400 && y <= 460) {
-                    encryptedWord.clear();
-                    decryptedWord.clear();
-                    cipherKey.clear();
-                    userInput.clear();
-                    showHint1 = false;
-                    showHint2 = false;
-                    gameWon = false;
-                }
-            }
-            else if (!encryptedWord.empty()) {
-
-                if (x >= 100 && x <= 300 && y >= 450 && y <= 510) {
-                    encryptedWord.clear();
-                    decryptedWord.clear();
-                    cipherKey.clear();
-                    userInput.clear();
-                    showHint1 = false;
-                    showHint2 = false;
-                }
-
-                else if (x >= 300 && x <= 500 && y >= 450 && y <= 510) {
-                    showHint1 = true;
-                }
-
-                else if (x >= 500 && x <= 700 && y >= 450 && y <= 510) {
-                    showHint2 = true;
-                }
-            }
-            else if (encryptedWord.empty()) {
-                if (x >= 250 && x <= 550) {
-                    if (y >= 220 && y <= 280) {
-                        showCipherScreen(CipherType::CAESAR);
-                    }
-                    else if (y >= 300 && y <= 360) {
-                        showCipherScreen(CipherType::AFFINE);
-                    }
-                    else if (y >= 380 && y <= 440) {
-                        showCipherScreen(CipherType::VIGENERE);
-                    }
-                }
+
+        if (options.animationIntervalMs > 0 && static_cast<Sint32>(SDL_GetTicks() - nextTick) >= 0) {
+            nextTick = SDL_GetTicks() + options.animationIntervalMs;
+            needsRedraw = true;
+        }
+    }
+}
+
+void Game::runReplay() {
+    Uint32 start = SDL_GetTicks();
+    for (const RecordedEvent& recorded : replayInput.events) {
+        if (!running) {
+            break;
+        }
+        if (!options.replayFast) {
+            Sint32 wait = static_cast<Sint32>(start + recorded.timeMs - SDL_GetTicks());
+            if (wait > 0) {
+                SDL_Delay(static_cast<Uint32>(wait));
             }
         }
+
+        SDL_Event e = toSdlEvent(recorded);
+        e.common.timestamp = SDL_GetTicks();
+        handleEvent(e);
+
+        // Настоящий ввод в скрытое окно не влияет на воспроизведение
+        SDL_Event ignored;
+        while (SDL_PollEvent(&ignored)) {}
+
+        if (needsRedraw || drawnRevision != core.revision()) {
+            render();
+        }
     }
 }
 
-void Game::render() {
-    SDL_SetRenderDrawColor(renderer, 240, 240, 240, 255);
-    SDL_RenderClear(renderer);
+void Game::runThreaded() {
+    publishState();
+    renderThread = std::thread(&Game::renderLoop, this);
+
+    while (running) {
+        SDL_Event e;
+        if (SDL_WaitEvent(&e)) {
+            handleEvent(e);
+            handleEvents();
+        }
+        publishState();
+    }
+    stopRenderThread();
+    if (renderError) {
+        std::rethrow_exception(renderError);
+    }
+}
+
+void Game::stopRenderThread() {
+    if (!renderThread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(renderMutex);
+        stopRendering = true;
+    }
+    renderWake.notify_one();
+    renderThread.join();
+}
+
+void Game::publishState() {
+    if (publishedRevision == core.revision() && !needsRedraw) {
+        return;
+    }
 
-    if (gameWon) {
-        showResult(true);
+    AIP_MEMORY_SCOPE(GAME_STATE);
+    GameSnapshot& snapshot = snapshots.back();
+    snapshot.state = core.state();
+    snapshot.revision = core.revision();
+    snapshots.publish();
+    publishedRevision = snapshot.revision;
+    needsRedraw = false;
+
+    {
+        std::lock_guard<std::mutex> lock(renderMutex);
+        renderSignal = true;
     }
-    else if (encryptedWord.empty()) {
-        showMainMenu();
+    renderWake.notify_one();
+}
+
+void Game::renderLoop() {
+    setTraceThreadName("render");
+    try {
+        view = std::make_unique<GameView>(window, options.vsync, options.headless);
+    } catch (...) {
+        // Исключение передается в runThreaded, а основной цикл будится событием выхода
+        renderError = std::current_exception();
+        SDL_Event quit{};
+        quit.type = SDL_QUIT;
+        SDL_PushEvent(&quit);
+        return;
     }
-    else {
-        renderCipherScreen();
+
+    auto ready = [this] { return renderSignal || stopRendering; };
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(renderMutex);
+            if (options.animationIntervalMs > 0) {
+                renderWake.wait_for(lock, std::chrono::milliseconds(options.animationIntervalMs), ready);
+            } else {
+                renderWake.wait(lock, ready);
+            }
+            if (stopRendering) {
+                break;
+            }
+            renderSignal = false;
+        }
+
+        snapshots.update();
+        drawFrame(snapshots.front().state, snapshots.front().revision);
     }
 
-    SDL_RenderPresent(renderer);
+    view.reset();
 }
 
-void Game::renderCipherScreen() {
-    SDL_Color black = {0, 0, 0, 255};
-    std::string cipherName;
-    switch (currentCipher) {
-        case CipherType::CAESAR: cipherName = "Caesar Cipher"; break;
-        case CipherType::AFFINE: cipherName = "Affine Cipher"; break;
-        case CipherType::VIGENERE: cipherName = "Vigenere Cipher"; break;
-    }
-    
-    SDL_Surface* cipherSurface = TTF_RenderText_Solid(font, cipherName.c_str(), black);
-    SDL_Texture* cipherTexture = SDL_CreateTextureFromSurface(renderer, cipherSurface);
-    SDL_Rect cipherRect = {400 - cipherSurface->w/2, 50, cipherSurface->w, cipherSurface->h};
-    SDL_RenderCopy(renderer, cipherTexture, nullptr, &cipherRect);
-    SDL_FreeSurface(cipherSurface);
-    SDL_DestroyTexture(cipherTexture);
-
-    SDL_Surface* encryptedSurface = TTF_RenderText_Solid(font, encryptedWord.c_str(), black);
-    SDL_Texture* encryptedTexture = SDL_CreateTextureFromSurface(renderer, encryptedSurface);
-    SDL_Rect encryptedRect = {400 - encryptedSurface->w/2, 150, encryptedSurface->w, encryptedSurface->h};
-    SDL_RenderCopy(renderer, encryptedTexture, nullptr, &encryptedRect);
-    SDL_FreeSurface(encryptedSurface);
-    SDL_DestroyTexture(encryptedTexture);
-
-    SDL_Rect inputRect = {50, 250, 700, 40};
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-    SDL_RenderFillRect(renderer, &inputRect);
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_RenderDrawRect(renderer, &inputRect);
-    
-    std::string inputPrompt = "Decrypt: " + userInput;
-    SDL_Surface* inputSurface = TTF_RenderText_Solid(font, inputPrompt.c_str(), black);
-    SDL_Texture* inputTexture = SDL_CreateTextureFromSurface(renderer, inputSurface);
-    SDL_Rect inputTextRect = {inputRect.x + 10, inputRect.y + (inputRect.h - inputSurface->h)/2, 
-                             inputSurface->w, inputSurface->h};
-    SDL_RenderCopy(renderer, inputTexture, nullptr, &inputTextRect);
-    SDL_FreeSurface(inputSurface);
-    SDL_DestroyTexture(inputTexture);
-
-    if (showHint1) {
-        std::string hintText = "Hint: First letter is '" + std::string(1, decryptedWord[0]) + "'";
-        SDL_Surface* hint1Surface = TTF_RenderText_Solid(font, hintText.c_str(), black);
-        SDL_Texture* hint1Texture = SDL_CreateTextureFromSurface(renderer, hint1Surface);
-        SDL_Rect hint1Rect = {400 - hint1Surface->w/2, 350, hint1Surface->w, hint1Surface->h};
-        SDL_RenderCopy(renderer, hint1Texture, nullptr, &hint1Rect); 
-        SDL_FreeSurface(hint1Surface);
-        SDL_DestroyTexture(hint1Texture);
-    }
-
-    if (showHint2) {
-        std::string hintText = "Key: " + cipherKey;
-        SDL_Surface* hint2Surface = TTF_RenderText_Solid(font, hintText.c_str(), black);
-        SDL_Texture* hint2Texture = SDL_CreateTextureFromSurface(renderer, hint2Surface);
-        SDL_Rect hint2Rect = {400 - hint2Surface->w/2, 400, hint2Surface->w, hint2Surface->h};
-        SDL_RenderCopy(renderer, hint2Texture, nullptr, &hint2Rect);
-        SDL_FreeSurface(hint2Surface);
-        SDL_DestroyTexture(hint2Texture);
-    }
-
-
-    SDL_Color buttonColor = {220, 220, 220, 255};
-    
-
-    SDL_Rect menuRect = {100, 450, 200, 60};
-    SDL_SetRenderDrawColor(renderer, buttonColor.r, buttonColor.g, buttonColor.b, buttonColor.a);
-    SDL_RenderFillRect(renderer, &menuRect);
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_RenderDrawRect(renderer, &menuRect);
-    
-    SDL_Surface* menuSurface = TTF_RenderText_Solid(font, "Menu", black);
-    SDL_Texture* menuTexture = SDL_CreateTextureFromSurface(renderer, menuSurface);
-    SDL_Rect menuTextRect = {menuRect.x + (menuRect.w - menuSurface->w)/2, 
-                            menuRect.y + (menuRect.h - menuSurface->h)/2, 
-                            menuSurface->w, menuSurface->h};
-    SDL_RenderCopy(renderer, menuTexture, nullptr, &menuTextRect);
-    SDL_FreeSurface(menuSurface);
-    SDL_DestroyTexture(menuTexture);
-
-    SDL_Rect hint1Rect = {300, 450, 200, 60};
-    SDL_SetRenderDrawColor(renderer, buttonColor.r, buttonColor.g, buttonColor.b, buttonColor.a);
-    SDL_RenderFillRect(renderer, &hint1Rect);
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_RenderDrawRect(renderer, &hint1Rect);
-    
-    SDL_Surface* hint1BtnSurface = TTF_RenderText_Solid(font, "Hint 1", black);
-    SDL_Texture* hint1BtnTexture = SDL_CreateTextureFromSurface(renderer, hint1BtnSurface);
-    SDL_Rect hint1BtnTextRect = {hint1Rect.x + (hint1Rect.w - hint1BtnSurface->w)/2, 
-                                hint1Rect.y + (hint1Rect.h - hint1BtnSurface->h)/2, 
-                                hint1BtnSurface->w, hint1BtnSurface->h};
-    SDL_RenderCopy(renderer, hint1BtnTexture, nullptr, &hint1BtnTextRect);
-    SDL_FreeSurface(hint1BtnSurface);
-    SDL_DestroyTexture(hint1BtnTexture);
-
-
-    SDL_Rect hint2Rect = {500, 450, 200, 60};
-    SDL_SetRenderDrawColor(renderer, buttonColor.r, buttonColor.g, buttonColor.b, buttonColor.a);
-    SDL_RenderFillRect(renderer, &hint2Rect);
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_RenderDrawRect(renderer, &hint2Rect);
-    
-    SDL_Surface* hint2BtnSurface = TTF_RenderText_Solid(font, "Hint 2", black);
-    SDL_Texture* hint2BtnTexture = SDL_CreateTextureFromSurface(renderer, hint2BtnSurface);
-    SDL_Rect hint2BtnTextRect = {hint2Rect.x + (hint2Rect.w - hint2BtnSurface->w)/2, 
-                                hint2Rect.y + (hint2Rect.h - hint2BtnSurface->h)/2, 
-                                hint2BtnSurface->w, hint2BtnSurface->h};
-    SDL_RenderCopy(renderer, hint2BtnTexture, nullptr, &hint2BtnTextRect);
-    SDL_FreeSurface(hint2BtnSurface);
-    SDL_DestroyTexture(hint2BtnTexture);
+void Game::handleEvents() {
+    AIP_TRACE_SCOPE("Game::handleEvents");
+    SDL_Event e;
+    while (SDL_PollEvent(&e)) {
+        handleEvent(e);
+    }
 }
 
-void Game::showMainMenu() {
-    SDL_Color black = {0, 0, 0, 255};
-    
-    TTF_Font* titleFont = TTF_OpenFont("NotoSans-Regular.ttf", 36);
-    SDL_Surface* titleSurface = TTF_RenderText_Solid(titleFont, "Cipher Challenge", black);
-    SDL_Texture* titleTexture = SDL_CreateTextureFromSurface(renderer, titleSurface);
-    SDL_Rect titleRect = {400 - titleSurface->w/2, 80, titleSurface->w, titleSurface->h};
-    SDL_RenderCopy(renderer, titleTexture, nullptr, &titleRect);
-    SDL_FreeSurface(titleSurface);
-    SDL_DestroyTexture(titleTexture);
-    TTF_CloseFont(titleFont);
-
-    SDL_Surface* subtitleSurface = TTF_RenderText_Solid(font, "Select Cipher Type:", black);
-    SDL_Texture* subtitleTexture = SDL_CreateTextureFromSurface(renderer, subtitleSurface);
-    SDL_Rect subtitleRect = {400 - subtitleSurface->w/2, 150, subtitleSurface->w, subtitleSurface->h};
-    SDL_RenderCopy(renderer, subtitleTexture, nullptr, &subtitleRect);
-    SDL_FreeSurface(subtitleSurface);
-    SDL_DestroyTexture(subtitleTexture);
-
-    SDL_Color buttonColor = {220, 220, 220, 255};
-    
-    SDL_Rect caesarRect = {250, 220, 300, 60};
-    SDL_SetRenderDrawColor(renderer, buttonColor.r, buttonColor.g, buttonColor.b, buttonColor.a);
-    SDL_RenderFillRect(renderer, &caesarRect);
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_RenderDrawRect(renderer, &caesarRect);
-    
-    SDL_Surface* caesarSurface = TTF_RenderText_Solid(font, "Caesar Cipher", black);
-    SDL_Texture* caesarTexture = SDL_CreateTextureFromSurface(renderer, caesarSurface);
-    SDL_Rect caesarTextRect = {caesarRect.x + (caesarRect.w - caesarSurface->w)/2, 
-                              caesarRect.y + (caesarRect.h - caesarSurface->h)/2, 
-                              caesarSurface->w, caesarSurface->h};
-    SDL_RenderCopy(renderer, caesarTexture, nullptr, &caesarTextRect);
-    SDL_FreeSurface(caesarSurface);
-    SDL_DestroyTexture(caesarTexture);
-
-    SDL_Rect affineRect = {250, 300, 300, 60};
-    SDL_SetRenderDrawColor(renderer, buttonColor.r, buttonColor.g, buttonColor.b, buttonColor.a);
-    SDL_RenderFillRect(renderer, &affineRect);
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_RenderDrawRect(renderer, &affineRect);
-    
-    SDL_Surface* affineSurface = TTF_RenderText_Solid(font, "Affine Cipher", black);
-    SDL_Texture* affineTexture = SDL_CreateTextureFromSurface(renderer, affineSurface);
-    SDL_Rect affineTextRect = {affineRect.x + (affineRect.w - affineSurface->w)/2, 
-                              affineRect.y + (affineRect.h - affineSurface->h)/2, 
-                              affineSurface->w, affineSurface->h};
-    SDL_RenderCopy(renderer, affineTexture, nullptr, &affineTextRect);
-    SDL_FreeSurface(affineSurface);
-    SDL_DestroyTexture(affineTexture);
-
-    SDL_Rect vigenereRect = {250, 380, 300, 60};
-    SDL_SetRenderDrawColor(renderer, buttonColor.r, buttonColor.g, buttonColor.b, buttonColor.a);
-    SDL_RenderFillRect(renderer, &vigenereRect);
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_RenderDrawRect(renderer, &vigenereRect);
-    
-    SDL_Surface* vigenereSurface = TTF_RenderText_Solid(font, "Vigenere Cipher", black);
-    SDL_Texture* vigenereTexture = SDL_CreateTextureFromSurface(renderer, vigenereSurface);
-    SDL_Rect vigenereTextRect = {vigenereRect.x + (vigenereRect.w - vigenereSurface->w)/2, 
-                                vigenereRect.y + (vigenereRect.h - vigenereSurface->h)/2, 
-                                vigenereSurface->w, vigenereSurface->h};
-    SDL_RenderCopy(renderer, vigenereTexture, nullptr, &vigenereTextRect);
-    SDL_FreeSurface(vigenereSurface);
-    SDL_DestroyTexture(vigenereTexture);
+void Game::handleEvent(const SDL_Event& e) {
+    AIP_TRACE_SCOPE("Game::handleEvent");
+    if (recorder) {
+        RecordedEvent recorded;
+        if (toRecordedEvent(e, recorded)) {
+            recorded.timeMs = e.common.timestamp - recordStart;
+            recorder->record(recorded);
+        }
+    }
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    uint64_t revision = core.revision();
+    dispatchEvent(e);
+    addStageTime(FrameStage::EVENTS, start);
+
+    // Отсчет идет от метки времени SDL, чтобы учесть и ожидание в очереди событий
+    if ((e.type == SDL_KEYDOWN || e.type == SDL_TEXTINPUT) && core.revision() != revision) {
+        Uint32 age = SDL_GetTicks() - e.common.timestamp;
+        latency.inputApplied(core.revision(), LatencyTracker::Clock::now() - std::chrono::milliseconds(age));
+    }
 }
 
-void Game::showCipherScreen(CipherType cipherType) {
-    currentCipher = cipherType;
-    
-    decryptedWord = [&]() {
-        switch (cipherType) {
-            case CipherType::CAESAR: return getRandomCaesarWord();
-            case CipherType::AFFINE: return getRandomAffineWord();
-            case CipherType::VIGENERE: return getRandomVigenereWord();
-            default: return std::string("");
+void Game::dispatchEvent(const SDL_Event& e) {
+    if (e.type == SDL_WINDOWEVENT) {
+        needsRedraw = true;
+    }
+
+    if (e.type == SDL_QUIT) {
+        running = false;
+    }
+    else if (e.type == SDL_KEYDOWN) {
+        if (e.key.keysym.sym == SDLK_ESCAPE) {
+            running = false;
         }
-    }();
-    
-    switch (cipherType) {
-        case CipherType::CAESAR: {
-            int key = generateCaesarKey();
-            cipherKey = std::to_string(key);
-            encryptedWord = caesarEncrypt(decryptedWord, key);
-            break;
+        else if (e.key.keysym.sym == SDLK_RETURN) {
+            core.checkAnswer();
         }
-        case CipherType::AFFINE: {
-            auto keys = generateAffineKeys();
-            cipherKey = std::to_string(keys.first) + ", " + std::to_string(keys.second);
-            encryptedWord = affineEncrypt(decryptedWord, keys.first, keys.second);
-            break;
+        else if (e.key.keysym.sym == SDLK_BACKSPACE) {
+            core.backspace();
         }
-        case CipherType::VIGENERE: {
-            cipherKey = generateVigenereKey();
-            encryptedWord = vigenereEncrypt(decryptedWord, cipherKey);
-            break;
+        else if (e.key.keysym.sym == SDLK_F3) {
+            showStats = !showStats;
+            needsRedraw = true;
+        }
+        else if (e.key.keysym.sym == SDLK_F4) {
+            writeTrace();
         }
     }
-    
-    userInput.clear();
-    showHint1 = false;
-    showHint2 = false;
-    gameWon = false;
+    else if (e.type == SDL_TEXTINPUT) {
+        core.typeText(e.text.text);
+    }
+    else if (e.type == SDL_MOUSEBUTTONDOWN) {
+        core.click(e.button.x, e.button.y);
+    }
 }
 
-void Game::showResult(bool correct) {
-    SDL_Color black = {0, 0, 0, 255};
-    SDL_Color color = correct ? SDL_Color{0, 150, 0, 255} : SDL_Color{150, 0, 0, 255};
-    std::string message = correct ? "Correct! Level passed!" : "Incorrect!";
-    
-    SDL_Surface* resultSurface = TTF_RenderText_Solid(font, message.c_str(), color);
-    SDL_Texture* resultTexture = SDL_CreateTextureFromSurface(renderer, resultSurface);
-    SDL_Rect resultRect = {400 - resultSurface->w/2, 200, resultSurface->w, resultSurface->h};
-    SDL_RenderCopy(renderer, resultTexture, nullptr, &resultRect);
-    SDL_FreeSurface(resultSurface);
-    SDL_DestroyTexture(resultTexture);
-
-    if (correct) {
-        std::string decryptedText = "Decrypted word: " + decryptedWord;
-        SDL_Surface* decryptedSurface = TTF_RenderText_Solid(font, decryptedText.c_str(), black);
-        SDL_Texture* decryptedTexture = SDL_CreateTextureFromSurface(renderer, decryptedSurface);
-        SDL_Rect decryptedRect = {400 - decryptedSurface->w/2, 250, decryptedSurface->w, decryptedSurface->h};
-        SDL_RenderCopy(renderer, decryptedTexture, nullptr, &decryptedRect);
-        SDL_FreeSurface(decryptedSurface);
-        SDL_DestroyTexture(decryptedTexture);
-
-        std::string keyText = "Key: " + cipherKey;
-        SDL_Surface* keySurface = TTF_RenderText_Solid(font, keyText.c_str(), black);
-        SDL_Texture* keyTexture = SDL_CreateTextureFromSurface(renderer, keySurface);
-        SDL_Rect keyRect = {400 - keySurface->w/2, 300, keySurface->w, keySurface->h};
-        SDL_RenderCopy(renderer, keyTexture, nullptr, &keyRect);
-        SDL_FreeSurface(keySurface);
-        SDL_DestroyTexture(keyTexture);
-
-        SDL_Color buttonColor = {220, 220, 220, 255};
-        
-        SDL_Rect sameRect = {200, 400, 200, 60};
-        SDL_SetRenderDrawColor(renderer, buttonColor.r, buttonColor.g, buttonColor.b, buttonColor.a);
-        SDL_RenderFillRect(renderer, &sameRect);
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-        SDL_RenderDrawRect(renderer, &sameRect);
-        
-        SDL_Surface* sameSurface = TTF_RenderText_Solid(font, "Same Cipher", black);
-        SDL_Texture* sameTexture = SDL_CreateTextureFromSurface(renderer, sameSurface);
-        SDL_Rect sameTextRect = {sameRect.x + (sameRect.w - sameSurface->w)/2, 
-                                sameRect.y + (sameRect.h - sameSurface->h)/2, 
-                                sameSurface->w, sameSurface->h};
-        SDL_RenderCopy(renderer, sameTexture, nullptr, &sameTextRect);
-        SDL_FreeSurface(sameSurface);
-        SDL_DestroyTexture(sameTexture);
-
-        SDL_Rect newRect = {400, 400, 200, 60};
-        SDL_SetRenderDrawColor(renderer, buttonColor.r, buttonColor.g, buttonColor.b, buttonColor.a);
-        SDL_RenderFillRect(renderer, &newRect);
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-        SDL_RenderDrawRect(renderer, &newRect);
-        
-        SDL_Surface* newSurface = TTF_RenderText_Solid(font, "New Cipher", black);
-        SDL_Texture* newTexture = SDL_CreateTextureFromSurface(renderer, newSurface);
-        SDL_Rect newTextRect = {newRect.x + (newRect.w - newSurface->w)/2, 
-                                newRect.y + (newRect.h - newSurface->h)/2, 
-                                newSurface->w, newSurface->h};
-        SDL_RenderCopy(renderer, newTexture, nullptr, &newTextRect);
-        SDL_FreeSurface(newSurface);
-        SDL_DestroyTexture(newTexture);
-    }
+void Game::render() {
+    drawFrame(core.state(), core.revision());
+    drawnRevision = core.revision();
+    needsRedraw = false;
 }
 
-void Game::checkAnswer() {
-    if (userInput == decryptedWord) {
-        gameWon = true;
+void Game::drawFrame(const GameState& state, uint64_t revision) {
+    AIP_TRACE_SCOPE("Game::drawFrame");
+    Uint64 start = SDL_GetPerformanceCounter();
+    Uint32 now = SDL_GetTicks();
+    if (!showStats) {
+        view->setOverlay({});
+        overlayUpdated = 0;
+    } else if (overlayUpdated == 0 || now - overlayUpdated >= 250) {
+        // Текст статистики меняется не чаще 4 раз в секунду, чтобы его можно было прочитать
+        std::vector<std::string> lines = frameStats.overlayLines();
+        LatencySummary input = latency.summary();
+        lines.push_back("input latency p50 " + std::to_string(static_cast<int>(input.p50Ms)) +
+                        "  p95 " + std::to_string(static_cast<int>(input.p95Ms)) +
+                        "  max " + std::to_string(static_cast<int>(input.maxMs)) + " ms");
+        view->setOverlay(lines);
+        overlayUpdated = now ? now : 1;
+    }
+
+    view->render(state, revision);
+    latency.framePresented(revision, LatencyTracker::Clock::now());
+
+    Uint64 end = SDL_GetPerformanceCounter();
+    double msPerTick = 1000.0 / SDL_GetPerformanceFrequency();
+    FrameSample sample;
+    // Время кадра - только работа над ним; промежуток между выводами включает ожидание событий
+    sample.frameMs = (end - start) * msPerTick;
+    sample.intervalMs = (lastPresent ? end - lastPresent : end - start) * msPerTick;
+    lastPresent = end;
+    frameTimes().observe(sample.frameMs / 1000.0);
+    addStageTime(FrameStage::RENDER, start);
+    for (size_t stage = 0; stage < stageTicks.size(); ++stage) {
+        sample.stageMs[stage] = stageTicks[stage].exchange(0) * msPerTick;
     }
-}
\ No newline at end of file
+
+    const RenderStats& rendered = view->lastFrame();
+    sample.drawCalls = rendered.drawCalls;
+    sample.vertices = rendered.vertices;
+    sample.texturesCreated = rendered.texturesCreated;
+    sample.texturesDestroyed = rendered.texturesDestroyed;
+    sample.textureUploads = rendered.textureUploads;
+
+    // Выделения всех потоков с прошлого кадра
+    MemoryUsage memory = totalMemoryUsage();
+    sample.allocations = memory.allocations - framedMemory.allocations;
+    sample.allocatedBytes = memory.allocatedBytes - framedMemory.allocatedBytes;
+    framedMemory = memory;
+    frameStats.addFrame(sample);
+}
+
+void Game::addStageTime(FrameStage stage, Uint64 start) {
+    stageTicks[static_cast<size_t>(stage)] += SDL_GetPerformanceCounter() - start;
+}
@@ -0,0 +1,144 @@
+#include "game_core.h"
+#include "memory_tracking.h"
+#include "metrics.h"
+#include "trace.h"
+#include <utility>
+
+namespace {
+
+Counter& roundsStarted() {
+    static Counter& counter = metrics().counter("aip_rounds_started_total", "Puzzles shown to the player");
+    return counter;
+}
+
+Counter& roundsWon() {
+    static Counter& counter = metrics().counter("aip_rounds_won_total", "Puzzles solved by the player");
+    return counter;
+}
+
+Counter& hintsUsed() {
+    static Counter& counter = metrics().counter("aip_hints_used_total", "Hints opened by the player");
+    return counter;
+}
+
+}
+
+GameState::GameState(std::pmr::memory_resource* resource)
+    : encryptedWord(resource), decryptedWord(resource), userInput(resource), cipherKey(resource) {}
+
+Screen GameState::screen() const {
+    if (gameWon) {
+        return Screen::RESULT;
+    }
+    return encryptedWord.empty() ? Screen::MAIN_MENU : Screen::CIPHER;
+}
+
+GameCore::GameCore(PuzzleSource source)
+    : source(std::move(source)), roundArena(roundBuffer.data(), roundBuffer.size()), current(&roundArena),
+      version(0) {}
+
+const GameState& GameCore::state() const {
+    return current;
+}
+
+uint64_t GameCore::revision() const {
+    return version;
+}
+
+void GameCore::showCipherScreen(CipherType cipherType) {
+    AIP_TRACE_SCOPE("GameCore::showCipherScreen");
+    AIP_MEMORY_SCOPE(GAME_STATE);
+    Puzzle puzzle = source(cipherType);
+    resetRound();
+    current.currentCipher = cipherType;
+    current.decryptedWord = puzzle.plaintext;
+    current.cipherKey = puzzle.key;
+    current.encryptedWord = puzzle.ciphertext;
+    ++version;
+    roundsStarted().add();
+}
+
+void GameCore::showMainMenu() {
+    AIP_MEMORY_SCOPE(GAME_STATE);
+    resetRound();
+    ++version;
+}
+
+void GameCore::typeText(std::string_view text) {
+    AIP_MEMORY_SCOPE(GAME_STATE);
+    if (!current.gameWon) {
+        current.userInput += text;
+        ++version;
+    }
+}
+
+void GameCore::backspace() {
+    AIP_MEMORY_SCOPE(GAME_STATE);
+    if (!current.gameWon && !current.userInput.empty()) {
+        current.userInput.pop_back();
+        ++version;
+    }
+}
+
+void GameCore::checkAnswer() {
+    if (!current.gameWon && current.userInput == current.decryptedWord) {
+        current.gameWon = true;
+        ++version;
+        roundsWon().add();
+    }
+}
+
+void GameCore::pressWidget(WidgetId id) {
+    switch (id) {
+        case WidgetId::CAESAR_BUTTON:
+            showCipherScreen(CipherType::CAESAR);
+            break;
+        case WidgetId::AFFINE_BUTTON:
+            showCipherScreen(CipherType::AFFINE);
+            break;
+        case WidgetId::VIGENERE_BUTTON:
+            showCipherScreen(CipherType::VIGENERE);
+            break;
+        case WidgetId::SAME_BUTTON:
+            showCipherScreen(current.currentCipher);
+            break;
+        case WidgetId::MENU_BUTTON:
+        case WidgetId::NEW_BUTTON:
+            showMainMenu();
+            break;
+        case WidgetId::HINT1_BUTTON:
+            if (!current.showHint1) {
+                hintsUsed().add();
+            }
+            current.showHint1 = true;
+            ++version;
+            break;
+        case WidgetId::HINT2_BUTTON:
+            if (!current.showHint2) {
+                hintsUsed().add();
+            }
+            current.showHint2 = true;
+            ++version;
+            break;
+        case WidgetId::INPUT_BOX:
+        case WidgetId::COUNT:
+            break;
+    }
+}
+
+void GameCore::resetRound() {
+    // Строки заменяются пустыми до release(), чтобы не ссылаться на освобожденную арену
+    CipherType cipher = current.currentCipher;
+    current = GameState(&roundArena);
+    current.currentCipher = cipher;
+    roundArena.release();
+}
+
+bool GameCore::click(int x, int y) {
+    const Widget* widget = screenLayout(current.screen()).hitTest(x, y);
+    if (!widget) {
+        return false;
+    }
+    pressWidget(widget->id);
+    return true;
+}
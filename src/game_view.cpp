@@ -0,0 +1,224 @@
+#include "game_view.h"
+#include "memory_tracking.h"
+#include "trace.h"
+#include <SDL2/SDL_ttf.h>
+#include <stdexcept>
+#include <string>
+
+
+GameView::GameView(SDL_Window* window, bool vsync, bool software)
+    : renderer(nullptr), overlayLines(0), labelsRevision(~uint64_t(0)),
+      frameScratch(scratchBuffer.data(), scratchBuffer.size()) {
+    Uint32 rendererFlags = software ? SDL_RENDERER_SOFTWARE : SDL_RENDERER_ACCELERATED;
+    if (vsync) {
+        rendererFlags |= SDL_RENDERER_PRESENTVSYNC;
+    }
+    renderer = SDL_CreateRenderer(window, -1, rendererFlags);
+    if (!renderer) {
+        throw std::runtime_error(std::string("Renderer could not be created! SDL_Error: ") + SDL_GetError());
+    }
+
+    try {
+        fonts = std::make_unique<FontManager>();
+        TTF_Font* font = fonts->get("NotoSans-Regular.ttf", 24);
+        TTF_Font* titleFont = fonts->get("NotoSans-Regular.ttf", 36);
+        if (!font || !titleFont) {
+            throw std::runtime_error(std::string("Failed to load font! TTF_Error: ") + TTF_GetError());
+        }
+
+        text = std::make_unique<TextRenderer>(renderer, font);
+        titleText = std::make_unique<TextRenderer>(renderer, titleFont);
+    } catch (...) {
+        titleText.reset();
+        text.reset();
+        fonts.reset();
+        SDL_DestroyRenderer(renderer);
+        throw;
+    }
+
+    batch = std::make_unique<RenderBatch>(renderer);
+    batch->addSolidSource(text->texture(), text->solidTexel());
+    batch->addSolidSource(titleText->texture(), titleText->solidTexel());
+
+    initLabels();
+}
+
+GameView::~GameView() {
+    batch.reset();
+    for (auto& slot : labels) {
+        slot.reset();
+    }
+    for (auto& slot : widgetLabels) {
+        slot.reset();
+    }
+    overlayLabels.clear();
+    text.reset();
+    titleText.reset();
+    fonts.reset();
+    SDL_DestroyRenderer(renderer);
+}
+
+void GameView::initLabels() {
+    for (size_t i = 0; i < labels.size(); ++i) {
+        bool isTitle = i == static_cast<size_t>(LabelSlot::TITLE);
+        labels[i] = std::make_unique<Label>(isTitle ? *titleText : *text);
+    }
+
+    const std::pair<LabelSlot, const char*> fixedTexts[] = {
+        {LabelSlot::TITLE, "Cipher Challenge"},
+        {LabelSlot::SUBTITLE, "Select Cipher Type:"}
+    };
+    for (const auto& [slot, str] : fixedTexts) {
+        label(slot).setText(str);
+    }
+
+    label(LabelSlot::TITLE).place(400, 80, LabelAlign::CENTER);
+    label(LabelSlot::SUBTITLE).place(400, 150, LabelAlign::CENTER);
+    label(LabelSlot::CIPHER_NAME).place(400, 50, LabelAlign::CENTER);
+    label(LabelSlot::ENCRYPTED).place(400, 150, LabelAlign::CENTER);
+    label(LabelSlot::HINT1).place(400, 350, LabelAlign::CENTER);
+    label(LabelSlot::HINT2).place(400, 400, LabelAlign::CENTER);
+    label(LabelSlot::RESULT).place(400, 200, LabelAlign::CENTER);
+    label(LabelSlot::DECRYPTED).place(400, 250, LabelAlign::CENTER);
+    label(LabelSlot::KEY).place(400, 300, LabelAlign::CENTER);
+
+    for (Screen screen : {Screen::MAIN_MENU, Screen::CIPHER, Screen::RESULT}) {
+        for (const Widget& widget : screenLayout(screen).widgets()) {
+            const UiRect& rect = widget.rect;
+            int textY = rect.y + (rect.h - text->lineHeight())/2;
+            if (widget.kind == WidgetKind::TEXT_BOX) {
+                label(LabelSlot::INPUT).place(rect.x + 10, textY);
+                continue;
+            }
+
+            auto& widgetLabel = widgetLabels[static_cast<size_t>(widget.id)];
+            widgetLabel = std::make_unique<Label>(*text);
+            widgetLabel->setText(widget.label);
+            widgetLabel->place(rect.x + rect.w/2, textY, LabelAlign::CENTER);
+        }
+    }
+}
+
+Label& GameView::label(LabelSlot slot) {
+    return *labels[static_cast<size_t>(slot)];
+}
+
+void GameView::render(const GameState& state, uint64_t revision) {
+    AIP_TRACE_SCOPE("GameView::render");
+    AIP_MEMORY_SCOPE(TEXT);
+    if (labelsRevision != revision) {
+        updateLabels(state);
+        labelsRevision = revision;
+    }
+
+    SDL_SetRenderDrawColor(renderer, 240, 240, 240, 255);
+    SDL_RenderClear(renderer);
+
+    switch (state.screen()) {
+        case Screen::RESULT: showResult(); break;
+        case Screen::MAIN_MENU: showMainMenu(); break;
+        case Screen::CIPHER: renderCipherScreen(state); break;
+    }
+    renderOverlay();
+
+    batch->endFrame();
+    SDL_RenderPresent(renderer);
+    frameScratch.release();
+}
+
+void GameView::setOverlay(const std::vector<std::string>& lines) {
+    while (overlayLabels.size() < lines.size()) {
+        int y = 5 + static_cast<int>(overlayLabels.size()) * text->lineHeight();
+        overlayLabels.push_back(std::make_unique<Label>(*text, SDL_Color{255, 255, 255, 255}));
+        overlayLabels.back()->place(10, y);
+    }
+    for (size_t i = 0; i < lines.size(); ++i) {
+        overlayLabels[i]->setText(lines[i]);
+    }
+    overlayLines = lines.size();
+}
+
+const RenderStats& GameView::lastFrame() const {
+    return batch->lastFrame();
+}
+
+void GameView::renderOverlay() {
+    if (overlayLines == 0) {
+        return;
+    }
+
+    int h = static_cast<int>(overlayLines) * text->lineHeight() + 10;
+    batch->fillRect(SDL_Rect{0, 0, 800, h}, SDL_Color{0, 0, 0, 180});
+    for (size_t i = 0; i < overlayLines; ++i) {
+        overlayLabels[i]->draw(*batch);
+    }
+}
+
+void GameView::updateLabels(const GameState& state) {
+    const char* cipherName = "";
+    switch (state.currentCipher) {
+        case CipherType::CAESAR: cipherName = "Caesar Cipher"; break;
+        case CipherType::AFFINE: cipherName = "Affine Cipher"; break;
+        case CipherType::VIGENERE: cipherName = "Vigenere Cipher"; break;
+    }
+    label(LabelSlot::CIPHER_NAME).setText(cipherName);
+    label(LabelSlot::ENCRYPTED).setText(state.encryptedWord);
+
+    std::pmr::string line(&frameScratch);
+    label(LabelSlot::INPUT).setText(line.assign("Decrypt: ").append(state.userInput));
+    if (!state.decryptedWord.empty()) {
+        line.assign("Hint: First letter is '").append(1, state.decryptedWord[0]).append("'");
+        label(LabelSlot::HINT1).setText(line);
+    }
+    label(LabelSlot::HINT2).setText(line.assign("Key: ").append(state.cipherKey));
+
+    label(LabelSlot::RESULT).setText(state.gameWon ? "Correct! Level passed!" : "Incorrect!");
+    label(LabelSlot::RESULT).setColor(state.gameWon ? SDL_Color{0, 150, 0, 255} : SDL_Color{150, 0, 0, 255});
+    label(LabelSlot::DECRYPTED).setText(line.assign("Decrypted word: ").append(state.decryptedWord));
+    label(LabelSlot::KEY).setText(line.assign("Key: ").append(state.cipherKey));
+}
+
+void GameView::renderWidgets(Screen screen) {
+    for (const Widget& widget : screenLayout(screen).widgets()) {
+        SDL_Rect rect = {widget.rect.x, widget.rect.y, widget.rect.w, widget.rect.h};
+        if (widget.kind == WidgetKind::TEXT_BOX) {
+            batch->fillRect(rect, SDL_Color{255, 255, 255, 255});
+            batch->drawRect(rect, SDL_Color{0, 0, 0, 255});
+        } else {
+            batch->fillRect(rect, SDL_Color{220, 220, 220, 255});
+            batch->drawRect(rect, SDL_Color{0, 0, 0, 255});
+            widgetLabels[static_cast<size_t>(widget.id)]->draw(*batch);
+        }
+    }
+}
+
+void GameView::renderCipherScreen(const GameState& state) {
+    label(LabelSlot::CIPHER_NAME).draw(*batch);
+    label(LabelSlot::ENCRYPTED).draw(*batch);
+
+    renderWidgets(Screen::CIPHER);
+    label(LabelSlot::INPUT).draw(*batch);
+
+    if (state.showHint1) {
+        label(LabelSlot::HINT1).draw(*batch);
+    }
+
+    if (state.showHint2) {
+        label(LabelSlot::HINT2).draw(*batch);
+    }
+}
+
+void GameView::showMainMenu() {
+    label(LabelSlot::TITLE).draw(*batch);
+    label(LabelSlot::SUBTITLE).draw(*batch);
+
+    renderWidgets(Screen::MAIN_MENU);
+}
+
+void GameView::showResult() {
+    label(LabelSlot::RESULT).draw(*batch);
+    label(LabelSlot::DECRYPTED).draw(*batch);
+    label(LabelSlot::KEY).draw(*batch);
+
+    renderWidgets(Screen::RESULT);
+}
@@ -0,0 +1,149 @@
+#include "input_record.h"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+namespace {
+
+/// Записать целое число в порядке байтов little-endian независимо от машины
+template <typename T>
+void put(std::ofstream& out, T value) {
+    auto bits = static_cast<std::make_unsigned_t<T>>(value);
+    char bytes[sizeof(T)];
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        bytes[i] = static_cast<char>(bits >> (8 * i));
+    }
+    out.write(bytes, sizeof(T));
+}
+
+/**
+ * @brief Последовательное чтение чисел из буфера с проверкой границ
+ */
+class Reader {
+public:
+    Reader(const std::vector<char>& data, const std::string& path) : data(data), path(path), pos(0) {}
+
+    bool done() const {
+        return pos == data.size();
+    }
+
+    /// Прочитать целое число, записанное put в порядке little-endian
+    template <typename T>
+    T get() {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(take(sizeof(T)));
+        std::make_unsigned_t<T> bits = 0;
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            bits |= static_cast<std::make_unsigned_t<T>>(bytes[i]) << (8 * i);
+        }
+        return static_cast<T>(bits);
+    }
+
+    std::string getText(size_t length) {
+        return std::string(take(length), length);
+    }
+
+private:
+    const std::vector<char>& data;
+    const std::string& path;
+    size_t pos;
+
+    const char* take(size_t size) {
+        if (data.size() - pos < size) {
+            throw std::runtime_error("Truncated input recording: " + path);
+        }
+        const char* start = data.data() + pos;
+        pos += size;
+        return start;
+    }
+};
+
+}
+
+InputRecorder::InputRecorder(const std::string& path, uint32_t seed) : out(path, std::ios::binary) {
+    if (!out) {
+        throw std::runtime_error("Cannot create input recording: " + path);
+    }
+
+    InputRecordHeader header{};
+    std::memcpy(header.magic, INPUT_RECORD_MAGIC, sizeof(INPUT_RECORD_MAGIC));
+    header.version = INPUT_RECORD_VERSION;
+    header.seed = seed;
+    out.write(header.magic, sizeof(header.magic));
+    put(out, header.version);
+    put(out, header.seed);
+    put(out, header.reserved);
+}
+
+void InputRecorder::record(const RecordedEvent& event) {
+    put(out, event.timeMs);
+    put(out, static_cast<uint8_t>(event.type));
+    switch (event.type) {
+        case RecordedEventType::KEY_DOWN:
+        case RecordedEventType::WINDOW:
+            put(out, event.code);
+            break;
+        case RecordedEventType::MOUSE_DOWN:
+            put(out, event.x);
+            put(out, event.y);
+            break;
+        case RecordedEventType::TEXT_INPUT: {
+            uint8_t length = static_cast<uint8_t>(std::min<size_t>(event.text.size(), 255));
+            put(out, length);
+            out.write(event.text.data(), length);
+            break;
+        }
+        case RecordedEventType::QUIT:
+            break;
+    }
+}
+
+InputRecording InputRecording::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open input recording: " + path);
+    }
+    std::vector<char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    Reader reader(data, path);
+    InputRecordHeader header;
+    std::memcpy(header.magic, reader.getText(sizeof(header.magic)).data(), sizeof(header.magic));
+    header.version = reader.get<uint32_t>();
+    header.seed = reader.get<uint32_t>();
+    header.reserved = reader.get<uint32_t>();
+    if (std::memcmp(header.magic, INPUT_RECORD_MAGIC, sizeof(INPUT_RECORD_MAGIC)) != 0
+        || header.version != INPUT_RECORD_VERSION) {
+        throw std::runtime_error("Invalid input recording: " + path);
+    }
+
+    InputRecording recording;
+    recording.seed = header.seed;
+    while (!reader.done()) {
+        RecordedEvent event;
+        event.timeMs = reader.get<uint32_t>();
+        uint8_t type = reader.get<uint8_t>();
+        if (type > static_cast<uint8_t>(RecordedEventType::WINDOW)) {
+            throw std::runtime_error("Invalid input recording: " + path);
+        }
+        event.type = static_cast<RecordedEventType>(type);
+
+        switch (event.type) {
+            case RecordedEventType::KEY_DOWN:
+            case RecordedEventType::WINDOW:
+                event.code = reader.get<int32_t>();
+                break;
+            case RecordedEventType::MOUSE_DOWN:
+                event.x = reader.get<int32_t>();
+                event.y = reader.get<int32_t>();
+                break;
+            case RecordedEventType::TEXT_INPUT:
+                event.text = reader.getText(reader.get<uint8_t>());
+                break;
+            case RecordedEventType::QUIT:
+                break;
+        }
+        recording.events.push_back(std::move(event));
+    }
+    return recording;
+}
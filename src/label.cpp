@@ -0,0 +1,46 @@
+#include "label.h"
+
+Label::Label(TextRenderer& textRenderer, SDL_Color color)
+    : textRenderer(textRenderer), color(color), x(0), y(0), align(LabelAlign::LEFT), dirty(true) {}
+
+void Label::setText(std::string_view newText) {
+    if (newText != str) {
+        str.assign(newText);
+        dirty = true;
+    }
+}
+
+void Label::setColor(SDL_Color newColor) {
+    if (newColor.r != color.r || newColor.g != color.g || newColor.b != color.b || newColor.a != color.a) {
+        color = newColor;
+        dirty = true;
+    }
+}
+
+void Label::place(int newX, int newY, LabelAlign newAlign) {
+    if (newX != x || newY != y || newAlign != align) {
+        x = newX;
+        y = newY;
+        align = newAlign;
+        dirty = true;
+    }
+}
+
+const std::string& Label::text() const {
+    return str;
+}
+
+void Label::rebuild() {
+    vertices.clear();
+    indices.clear();
+    int left = align == LabelAlign::CENTER ? x - textRenderer.measure(str)/2 : x;
+    textRenderer.layout(str, left, y, color, vertices, indices);
+    dirty = false;
+}
+
+void Label::draw(RenderBatch& batch) {
+    if (dirty) {
+        rebuild();
+    }
+    batch.addGeometry(textRenderer.texture(), vertices, indices);
+}
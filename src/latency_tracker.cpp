@@ -0,0 +1,101 @@
+#include "latency_tracker.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace {
+
+const size_t MAX_PENDING = 1024; ///< Больше событий без кадра означает, что отрисовка остановилась
+
+}
+
+const std::array<double, LatencyTracker::BUCKETS - 1> LatencyTracker::BUCKET_BOUNDS_MS = {
+    1, 2, 4, 8, 12, 16, 20, 25, 33, 50, 66, 100, 150, 250, 500, 1000
+};
+
+LatencyTracker::LatencyTracker()
+    : buckets{}, count(0), dropped(0), totalMs(0), maxMs(0), started(Clock::now()) {}
+
+void LatencyTracker::inputApplied(uint64_t revision, Clock::time_point occurred) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (pending.size() == MAX_PENDING) {
+        pending.pop_front();
+        ++dropped;
+    }
+    pending.push_back(PendingInput{revision, occurred});
+}
+
+void LatencyTracker::framePresented(uint64_t revision, Clock::time_point presented) {
+    std::lock_guard<std::mutex> lock(mutex);
+    while (!pending.empty() && pending.front().revision <= revision) {
+        double ms = std::chrono::duration<double, std::milli>(presented - pending.front().occurred).count();
+        ms = std::max(ms, 0.0);
+        pending.pop_front();
+
+        size_t bucket = std::upper_bound(BUCKET_BOUNDS_MS.begin(), BUCKET_BOUNDS_MS.end(), ms)
+                        - BUCKET_BOUNDS_MS.begin();
+        if (bucket > 0 && ms == BUCKET_BOUNDS_MS[bucket - 1]) {
+            --bucket; // границы корзин включительные
+        }
+        ++buckets[bucket];
+        ++count;
+        totalMs += ms;
+        maxMs = std::max(maxMs, ms);
+    }
+}
+
+double LatencyTracker::percentile(double fraction) const {
+    if (count == 0) {
+        return 0;
+    }
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(fraction * count)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return i < BUCKET_BOUNDS_MS.size() ? std::min(BUCKET_BOUNDS_MS[i], maxMs) : maxMs;
+        }
+    }
+    return maxMs;
+}
+
+LatencySummary LatencyTracker::summary() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    LatencySummary result;
+    result.count = count;
+    result.dropped = dropped;
+    result.meanMs = count ? totalMs / count : 0;
+    result.maxMs = maxMs;
+    result.p50Ms = percentile(0.50);
+    result.p95Ms = percentile(0.95);
+    result.p99Ms = percentile(0.99);
+    return result;
+}
+
+std::string LatencyTracker::toJson() const {
+    LatencySummary s = summary();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    double sessionSeconds = std::chrono::duration<double>(Clock::now() - started).count();
+    std::ostringstream out;
+    out << "{\"session_seconds\": " << sessionSeconds
+        << ", \"count\": " << s.count
+        << ", \"dropped\": " << s.dropped
+        << ", \"mean_ms\": " << s.meanMs
+        << ", \"max_ms\": " << s.maxMs
+        << ", \"p50_ms\": " << s.p50Ms
+        << ", \"p95_ms\": " << s.p95Ms
+        << ", \"p99_ms\": " << s.p99Ms
+        << ", \"histogram\": [";
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        out << (i ? ", " : "") << "{\"le_ms\": ";
+        if (i < BUCKET_BOUNDS_MS.size()) {
+            out << BUCKET_BOUNDS_MS[i];
+        } else {
+            out << "null";
+        }
+        out << ", \"count\": " << buckets[i] << "}";
+    }
+    out << "]}";
+    return out.str();
+}
@@ -1,7 +1,145 @@
 #include "game.h"
+#include "database.h"
+#include "game_core.h"
+#include "memory_tracking.h"
+#include "trace.h"
+#include "wordpack.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
 
-int main() {
-    Game game;
-    game.run();
+static void simulate(int rounds) {
+    const WidgetId buttons[] = {WidgetId::CAESAR_BUTTON, WidgetId::AFFINE_BUTTON, WidgetId::VIGENERE_BUTTON};
+    GameCore core;
+    int won = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        core.pressWidget(buttons[round % 3]);
+        core.typeText(core.state().decryptedWord);
+        core.checkAnswer();
+        won += core.state().gameWon ? 1 : 0;
+        core.pressWidget(WidgetId::NEW_BUTTON);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << won << "/" << rounds << " rounds won in " << elapsed.count() << " s ("
+              << rounds / elapsed.count() << " rounds/s)" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    GameOptions options;
+    try {
+        installSqliteMemoryHooks();
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--build-wordpack" && i + 1 < argc) {
+                Database db("ciphers_database.db");
+                WordPack::build(db, argv[++i]);
+                return 0;
+            }
+            else if (arg == "--simulate" && i + 1 < argc) {
+                simulate(std::stoi(argv[++i]));
+                return 0;
+            }
+            else if (arg == "--build-puzzles") {
+                Database db("ciphers_database.db");
+                db.buildPuzzles();
+                return 0;
+            }
+            else if (arg == "--wordpack" && i + 1 < argc) {
+                useWordPack(argv[++i]);
+            }
+            else if (arg == "--event-driven") {
+                options.eventDriven = true;
+            }
+            else if (arg == "--vsync") {
+                options.vsync = true;
+            }
+            else if (arg == "--stats-file" && i + 1 < argc) {
+                options.statsFile = argv[++i];
+            }
+            else if (arg == "--latency-file" && i + 1 < argc) {
+                options.latencyFile = argv[++i];
+            }
+            else if (arg == "--record" && i + 1 < argc) {
+                options.recordFile = argv[++i];
+            }
+            else if (arg == "--seed" && i + 1 < argc) {
+                options.randomSeed = static_cast<uint32_t>(std::stoul(argv[++i]));
+            }
+            else if (arg == "--replay" && i + 1 < argc) {
+                options.replayFile = argv[++i];
+            }
+            else if (arg == "--replay-fast") {
+                options.replayFast = true;
+            }
+            else if (arg == "--headless") {
+                options.headless = true;
+            }
+            else if (arg == "--render-thread") {
+#ifdef __APPLE__
+                // Cocoa разрешает работать с окном и его рендерером только из главного потока
+                std::cerr << "--render-thread is not supported on macOS: SDL must render on the main thread" << std::endl;
+                return 1;
+#else
+                options.renderThread = true;
+#endif
+            }
+            else if (arg == "--trace-file" && i + 1 < argc) {
+                if (!TRACING_ENABLED) {
+                    std::cerr << "--trace-file requires a build with -DAIP_TRACING=ON" << std::endl;
+                    return 1;
+                }
+                options.traceFile = argv[++i];
+            }
+            else if (arg == "--metrics-file" && i + 1 < argc) {
+                options.metricsFile = argv[++i];
+            }
+            else if (arg == "--metrics-interval" && i + 1 < argc) {
+                options.metricsIntervalMs = std::max(100, std::stoi(argv[++i]));
+            }
+            else if (arg == "--memory-file" && i + 1 < argc) {
+                if (!MEMORY_TRACKING_ENABLED) {
+                    std::cerr << "--memory-file requires a build with -DAIP_MEMORY_TRACKING=ON" << std::endl;
+                    return 1;
+                }
+                options.memoryFile = argv[++i];
+            }
+            else if (arg == "--slow-query-ms" && i + 1 < argc) {
+                double ms = std::stod(argv[++i]);
+                Database::setSlowQueryThreshold(std::chrono::microseconds(static_cast<long long>(ms * 1000)));
+            }
+            else if (arg == "--animation-interval" && i + 1 < argc) {
+                options.animationIntervalMs = std::stoi(argv[++i]);
+            }
+            else {
+                std::cerr << "Usage: " << argv[0]
+                          << " [--wordpack <file>] [--build-wordpack <file>] [--build-puzzles]"
+                          << " [--event-driven] [--vsync] [--animation-interval <ms>]"
+                          << " [--render-thread] [--stats-file <file>] [--latency-file <file>] [--trace-file <file>]"
+                          << " [--metrics-file <file> [--metrics-interval <ms>]] [--slow-query-ms <ms>]"
+                          << " [--memory-file <file>]"
+                          << " [--record <file> [--seed <n>]] [--replay <file> [--replay-fast] [--headless]]"
+                          << " [--simulate <rounds>]" << std::endl;
+                return 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    // Ошибки запуска передаются сюда исключением, чтобы фоновые потоки
+    // игры были остановлены до выхода из программы
+    try {
+        Game game(options);
+        game.run();
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,257 @@
+#include "memory_tracking.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <sqlite3.h>
+
+namespace {
+
+const size_t SUBSYSTEM_COUNT = static_cast<size_t>(MemorySubsystem::COUNT);
+
+/**
+ * @struct Counters
+ * @brief Счетчики подсистемы (инициализируются до первого выделения памяти)
+ */
+struct Counters {
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> frees{0};
+    std::atomic<uint64_t> allocatedBytes{0};
+    std::atomic<int64_t> currentBytes{0};
+    std::atomic<int64_t> peakBytes{0};
+};
+
+std::array<Counters, SUBSYSTEM_COUNT> counters;
+std::atomic<int64_t> totalCurrentBytes{0};
+std::atomic<int64_t> totalPeakBytes{0};
+
+#ifdef AIP_MEMORY_TRACKING
+
+/**
+ * @struct BlockHeader
+ * @brief Заголовок перед каждым выделенным блоком
+ *
+ * Хранит размер и подсистему, чтобы освобождение уменьшало счетчики той
+ * подсистемы, которая выделила блок. Размер 16 байт сохраняет выравнивание malloc.
+ */
+struct alignas(16) BlockHeader {
+    size_t size;               ///< Запрошенный размер
+    MemorySubsystem subsystem; ///< Подсистема, выделившая блок
+};
+
+static_assert(sizeof(BlockHeader) == 16, "BlockHeader keeps malloc alignment");
+
+void raisePeak(std::atomic<int64_t>& peak, int64_t value) {
+    int64_t current = peak.load(std::memory_order_relaxed);
+    while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+void countAllocation(MemorySubsystem subsystem, size_t size) {
+    Counters& c = counters[static_cast<size_t>(subsystem)];
+    c.allocations.fetch_add(1, std::memory_order_relaxed);
+    c.allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    raisePeak(c.peakBytes, c.currentBytes.fetch_add(size, std::memory_order_relaxed) + static_cast<int64_t>(size));
+    raisePeak(totalPeakBytes, totalCurrentBytes.fetch_add(size, std::memory_order_relaxed) + static_cast<int64_t>(size));
+}
+
+void countFree(MemorySubsystem subsystem, size_t size) {
+    Counters& c = counters[static_cast<size_t>(subsystem)];
+    c.frees.fetch_add(1, std::memory_order_relaxed);
+    c.currentBytes.fetch_sub(size, std::memory_order_relaxed);
+    totalCurrentBytes.fetch_sub(size, std::memory_order_relaxed);
+}
+
+BlockHeader* headerOf(void* pointer) {
+    return static_cast<BlockHeader*>(pointer) - 1;
+}
+
+void* allocate(size_t size, MemorySubsystem subsystem) {
+    BlockHeader* header = static_cast<BlockHeader*>(std::malloc(sizeof(BlockHeader) + size));
+    if (!header) {
+        return nullptr;
+    }
+    header->size = size;
+    header->subsystem = subsystem;
+    countAllocation(subsystem, size);
+    return header + 1;
+}
+
+void release(void* pointer) {
+    if (!pointer) {
+        return;
+    }
+    BlockHeader* header = headerOf(pointer);
+    countFree(header->subsystem, header->size);
+    std::free(header);
+}
+
+void* reallocate(void* pointer, size_t size, MemorySubsystem subsystem) {
+    if (!pointer) {
+        return allocate(size, subsystem);
+    }
+    BlockHeader* header = headerOf(pointer);
+    MemorySubsystem owner = header->subsystem;
+    size_t oldSize = header->size;
+    BlockHeader* moved = static_cast<BlockHeader*>(std::realloc(header, sizeof(BlockHeader) + size));
+    if (!moved) {
+        return nullptr;
+    }
+    // Перевыделение считается освобождением старого блока и выделением нового
+    countFree(owner, oldSize);
+    moved->size = size;
+    countAllocation(owner, size);
+    return moved + 1;
+}
+
+void* sqliteMalloc(int size) {
+    return allocate(static_cast<size_t>(size), MemorySubsystem::DATABASE);
+}
+
+void sqliteFree(void* pointer) {
+    release(pointer);
+}
+
+void* sqliteRealloc(void* pointer, int size) {
+    return reallocate(pointer, static_cast<size_t>(size), MemorySubsystem::DATABASE);
+}
+
+int sqliteSize(void* pointer) {
+    return pointer ? static_cast<int>(headerOf(pointer)->size) : 0;
+}
+
+int sqliteRoundup(int size) {
+    return (size + 7) & ~7;
+}
+
+int sqliteInit(void*) {
+    return SQLITE_OK;
+}
+
+void sqliteShutdown(void*) {}
+
+#endif
+
+void writeUsage(std::ostringstream& out, const MemoryUsage& usage) {
+    out << "{\"allocations\": " << usage.allocations << ", \"frees\": " << usage.frees
+        << ", \"allocated_bytes\": " << usage.allocatedBytes << ", \"current_bytes\": " << usage.currentBytes
+        << ", \"peak_bytes\": " << usage.peakBytes << "}";
+}
+
+}
+
+const char* memorySubsystemName(MemorySubsystem subsystem) {
+    switch (subsystem) {
+        case MemorySubsystem::OTHER: return "other";
+        case MemorySubsystem::CIPHER: return "cipher";
+        case MemorySubsystem::DATABASE: return "database";
+        case MemorySubsystem::TEXT: return "text";
+        case MemorySubsystem::GAME_STATE: return "game_state";
+        case MemorySubsystem::COUNT: break;
+    }
+    return "unknown";
+}
+
+MemoryUsage memoryUsage(MemorySubsystem subsystem) {
+    const Counters& c = counters[static_cast<size_t>(subsystem)];
+    MemoryUsage usage;
+    usage.allocations = c.allocations.load(std::memory_order_relaxed);
+    usage.frees = c.frees.load(std::memory_order_relaxed);
+    usage.allocatedBytes = c.allocatedBytes.load(std::memory_order_relaxed);
+    usage.currentBytes = c.currentBytes.load(std::memory_order_relaxed);
+    usage.peakBytes = c.peakBytes.load(std::memory_order_relaxed);
+    return usage;
+}
+
+MemoryUsage totalMemoryUsage() {
+    MemoryUsage total;
+    for (size_t i = 0; i < SUBSYSTEM_COUNT; ++i) {
+        MemoryUsage usage = memoryUsage(static_cast<MemorySubsystem>(i));
+        total.allocations += usage.allocations;
+        total.frees += usage.frees;
+        total.allocatedBytes += usage.allocatedBytes;
+    }
+    total.currentBytes = totalCurrentBytes.load(std::memory_order_relaxed);
+    total.peakBytes = totalPeakBytes.load(std::memory_order_relaxed);
+    return total;
+}
+
+std::string memoryUsageJson() {
+    std::ostringstream out;
+    out << "{\"enabled\": " << (MEMORY_TRACKING_ENABLED ? "true" : "false") << ", \"total\": ";
+    writeUsage(out, totalMemoryUsage());
+    out << ", \"subsystems\": {";
+    for (size_t i = 0; i < SUBSYSTEM_COUNT; ++i) {
+        MemorySubsystem subsystem = static_cast<MemorySubsystem>(i);
+        out << (i ? ", " : "") << "\"" << memorySubsystemName(subsystem) << "\": ";
+        writeUsage(out, memoryUsage(subsystem));
+    }
+    out << "}}";
+    return out.str();
+}
+
+#ifdef AIP_MEMORY_TRACKING
+
+void* trackedMalloc(size_t size) {
+    return allocate(size, currentMemorySubsystem);
+}
+
+void* trackedCalloc(size_t count, size_t size) {
+    if (size != 0 && count > SIZE_MAX / size) {
+        return nullptr;
+    }
+    void* pointer = allocate(count * size, currentMemorySubsystem);
+    if (pointer) {
+        std::memset(pointer, 0, count * size);
+    }
+    return pointer;
+}
+
+void* trackedRealloc(void* pointer, size_t size) {
+    return reallocate(pointer, size, currentMemorySubsystem);
+}
+
+void trackedFree(void* pointer) {
+    release(pointer);
+}
+
+void installSqliteMemoryHooks() {
+    static sqlite3_mem_methods methods = {
+        sqliteMalloc, sqliteFree, sqliteRealloc, sqliteSize, sqliteRoundup, sqliteInit, sqliteShutdown, nullptr,
+    };
+    if (sqlite3_config(SQLITE_CONFIG_MALLOC, &methods) != SQLITE_OK) {
+        throw std::runtime_error("SQLite memory hooks must be installed before SQLite is used");
+    }
+}
+
+void* operator new(std::size_t size) {
+    if (void* pointer = allocate(size ? size : 1, currentMemorySubsystem)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept {
+    release(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    release(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    release(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+    release(pointer);
+}
+
+#endif
@@ -0,0 +1,251 @@
+#include "metrics.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+std::atomic<size_t> nextShard{0};
+
+/**
+ * @brief Часть счетчика для текущего потока (потоки получают части по очереди)
+ */
+size_t threadShard(size_t shards) {
+    thread_local size_t shard = nextShard.fetch_add(1, std::memory_order_relaxed);
+    return shard % shards;
+}
+
+/**
+ * @brief Записать метки в формате Prometheus: name="value",...
+ */
+std::string formatLabels(const MetricLabels& labels) {
+    std::string result;
+    for (const auto& [name, value] : labels) {
+        if (!result.empty()) {
+            result += ',';
+        }
+        result += name + "=\"";
+        for (char c : value) {
+            if (c == '\\' || c == '"') {
+                result += '\\';
+                result += c;
+            } else if (c == '\n') {
+                result += "\\n";
+            } else {
+                result += c;
+            }
+        }
+        result += '"';
+    }
+    return result;
+}
+
+/**
+ * @brief Метки вместе с дополнительной (le для корзин) в фигурных скобках
+ */
+std::string withLabels(const std::string& labels, const std::string& extra) {
+    if (labels.empty() && extra.empty()) {
+        return "";
+    }
+    return "{" + labels + (labels.empty() || extra.empty() ? "" : ",") + extra + "}";
+}
+
+std::string jsonEscape(const std::string& text) {
+    std::string result;
+    for (char c : text) {
+        if (c == '\\' || c == '"') {
+            result += '\\';
+        }
+        result += c;
+    }
+    return result;
+}
+
+bool endsWith(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+}
+
+void Counter::add(uint64_t amount) {
+    shards[threadShard(SHARDS)].value.fetch_add(amount, std::memory_order_relaxed);
+}
+
+uint64_t Counter::value() const {
+    uint64_t total = 0;
+    for (const Shard& shard : shards) {
+        total += shard.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+Histogram::Histogram(std::vector<double> bounds)
+    : bounds(std::move(bounds)), counts(new std::atomic<uint64_t>[this->bounds.size() + 1]), sum(0) {
+    for (size_t i = 0; i <= this->bounds.size(); ++i) {
+        counts[i] = 0;
+    }
+}
+
+void Histogram::observe(double value) {
+    size_t bucket = std::lower_bound(bounds.begin(), bounds.end(), value) - bounds.begin();
+    counts[bucket].fetch_add(1, std::memory_order_relaxed);
+
+    double current = sum.load(std::memory_order_relaxed);
+    while (!sum.compare_exchange_weak(current, current + value, std::memory_order_relaxed)) {}
+}
+
+HistogramSnapshot Histogram::snapshot() const {
+    HistogramSnapshot result;
+    result.bounds = bounds;
+    for (size_t i = 0; i <= bounds.size(); ++i) {
+        result.counts.push_back(counts[i].load(std::memory_order_relaxed));
+        result.count += result.counts.back();
+    }
+    result.sum = sum.load(std::memory_order_relaxed);
+    return result;
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help, const MetricLabels& labels) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Entry<Counter>& entry = counters[{name, formatLabels(labels)}];
+    if (!entry.metric) {
+        entry.help = help;
+        entry.metric = std::make_unique<Counter>();
+    }
+    return *entry.metric;
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name, const std::string& help,
+                                      const std::vector<double>& bounds, const MetricLabels& labels) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Entry<Histogram>& entry = histograms[{name, formatLabels(labels)}];
+    if (!entry.metric) {
+        entry.help = help;
+        entry.metric = std::make_unique<Histogram>(bounds);
+    }
+    return *entry.metric;
+}
+
+std::string MetricsRegistry::toPrometheus() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::ostringstream out;
+    const std::string* described = nullptr;
+    // Метрики с одним именем идут в словаре подряд; описание выводится один раз
+    auto describe = [&](const std::string& name, const std::string& help, const char* type) {
+        if (!described || *described != name) {
+            out << "# HELP " << name << " " << help << "\n"
+                << "# TYPE " << name << " " << type << "\n";
+            described = &name;
+        }
+    };
+
+    for (const auto& [key, entry] : counters) {
+        describe(key.first, entry.help, "counter");
+        out << key.first << withLabels(key.second, "") << " " << entry.metric->value() << "\n";
+    }
+    for (const auto& [key, entry] : histograms) {
+        const std::string& name = key.first;
+        describe(name, entry.help, "histogram");
+        HistogramSnapshot h = entry.metric->snapshot();
+        // Корзины Prometheus накопительные
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i < h.bounds.size(); ++i) {
+            cumulative += h.counts[i];
+            std::ostringstream bound;
+            bound << "le=\"" << h.bounds[i] << "\"";
+            out << name << "_bucket" << withLabels(key.second, bound.str()) << " " << cumulative << "\n";
+        }
+        out << name << "_bucket" << withLabels(key.second, "le=\"+Inf\"") << " " << h.count << "\n"
+            << name << "_sum" << withLabels(key.second, "") << " " << h.sum << "\n"
+            << name << "_count" << withLabels(key.second, "") << " " << h.count << "\n";
+    }
+    return out.str();
+}
+
+std::string MetricsRegistry::toJson() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::ostringstream out;
+    out << "{\"counters\": {";
+    bool first = true;
+    for (const auto& [key, entry] : counters) {
+        out << (first ? "" : ", ") << "\"" << jsonEscape(key.first + withLabels(key.second, "")) << "\": "
+            << entry.metric->value();
+        first = false;
+    }
+    out << "}, \"histograms\": {";
+    first = true;
+    for (const auto& [key, entry] : histograms) {
+        HistogramSnapshot h = entry.metric->snapshot();
+        out << (first ? "" : ", ") << "\"" << jsonEscape(key.first + withLabels(key.second, ""))
+            << "\": {\"bounds\": [";
+        for (size_t i = 0; i < h.bounds.size(); ++i) {
+            out << (i ? ", " : "") << h.bounds[i];
+        }
+        out << "], \"counts\": [";
+        for (size_t i = 0; i < h.counts.size(); ++i) {
+            out << (i ? ", " : "") << h.counts[i];
+        }
+        out << "], \"count\": " << h.count << ", \"sum\": " << h.sum << "}";
+        first = false;
+    }
+    out << "}}";
+    return out.str();
+}
+
+MetricsRegistry& metrics() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+const std::vector<double>& latencyBuckets() {
+    static const std::vector<double> bounds = {
+        0.00001, 0.000025, 0.00005, 0.0001, 0.00025, 0.0005, 0.001, 0.0025,
+        0.005, 0.01, 0.016, 0.025, 0.033, 0.05, 0.1, 0.25, 0.5, 1.0,
+    };
+    return bounds;
+}
+
+MetricsWriter::MetricsWriter(const MetricsRegistry& registry, std::string path, std::chrono::milliseconds interval)
+    : registry(registry), path(std::move(path)), interval(interval), stopping(false) {
+    thread = std::thread(&MetricsWriter::loop, this);
+}
+
+MetricsWriter::~MetricsWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    thread.join();
+}
+
+void MetricsWriter::write() const {
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary);
+        out << (endsWith(path, ".json") ? registry.toJson() + "\n" : registry.toPrometheus());
+        if (!out) {
+            throw std::runtime_error("Failed to write metrics to " + temporary);
+        }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Failed to replace " + path);
+    }
+}
+
+void MetricsWriter::loop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    bool last = false;
+    while (!last) {
+        last = wake.wait_for(lock, interval, [this] { return stopping; });
+        try {
+            write();
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+        }
+    }
+}
@@ -0,0 +1,104 @@
+#include "puzzle_prefetcher.h"
+#include "trace.h"
+#include <utility>
+
+PuzzlePrefetcher::PuzzlePrefetcher(PuzzleSource source, size_t capacity)
+    : source(std::move(source)), capacity(capacity),
+      queues{SpscQueue<Puzzle>(capacity), SpscQueue<Puzzle>(capacity), SpscQueue<Puzzle>(capacity)},
+      refills(3 * capacity), missCount(0), stopping(false) {
+    producer = std::thread(&PuzzlePrefetcher::produce, this);
+}
+
+PuzzlePrefetcher::~PuzzlePrefetcher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    producerWake.notify_one();
+    producer.join();
+}
+
+Puzzle PuzzlePrefetcher::next(CipherType cipherType) {
+    AIP_TRACE_SCOPE("PuzzlePrefetcher::next");
+    SpscQueue<Puzzle>& queue = queues[static_cast<size_t>(cipherType)];
+
+    Puzzle puzzle;
+    if (!queue.pop(puzzle)) {
+        ++missCount;
+        std::unique_lock<std::mutex> lock(mutex);
+        bool popped = false;
+        consumerWake.wait(lock, [&] {
+            popped = queue.pop(puzzle);
+            return popped || failure;
+        });
+        if (!popped) {
+            std::rethrow_exception(failure);
+        }
+    }
+
+    // Захват мьютекса не дает уведомлению потеряться, пока фоновый поток
+    // проверяет условие сна; он не конкурирует с производителем, который
+    // держит мьютекс только на время уведомления
+    refills.push(CipherType(cipherType));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+    }
+    producerWake.notify_one();
+    return puzzle;
+}
+
+uint64_t PuzzlePrefetcher::misses() const {
+    return missCount.load(std::memory_order_relaxed);
+}
+
+bool PuzzlePrefetcher::produceOne(CipherType cipherType) {
+    try {
+        queues[static_cast<size_t>(cipherType)].push(source(cipherType));
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        failure = std::current_exception();
+        consumerWake.notify_one();
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    consumerWake.notify_one();
+    return !stopping;
+}
+
+void PuzzlePrefetcher::produce() {
+    setTraceThreadName("prefetch");
+    const CipherType types[] = {CipherType::CAESAR, CipherType::AFFINE, CipherType::VIGENERE};
+
+    // Головоломки создаются в порядке, который зависит только от порядка
+    // вызовов next(), а не от скорости потоков: сначала очереди заполняются
+    // по кругу, затем каждая взятая головоломка заменяется в порядке запросов.
+    // Поэтому после seedRandom игра с одним и тем же вводом воспроизводима.
+    for (size_t round = 0; round < capacity; ++round) {
+        for (CipherType type : types) {
+            if (!produceOne(type)) {
+                return;
+            }
+        }
+    }
+
+    while (true) {
+        CipherType type;
+        if (refills.pop(type)) {
+            if (!produceOne(type)) {
+                return;
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        producerWake.wait(lock, [this, &type] { return stopping || refills.pop(type); });
+        if (stopping) {
+            return;
+        }
+        lock.unlock();
+        if (!produceOne(type)) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,128 @@
+#include "render_batch.h"
+#include <atomic>
+
+namespace {
+
+std::atomic<int> texturesCreated{0};
+std::atomic<int> texturesDestroyed{0};
+std::atomic<int> textureUploads{0};
+
+}
+
+void countTextureCreated() {
+    texturesCreated.fetch_add(1, std::memory_order_relaxed);
+}
+
+void countTextureDestroyed() {
+    texturesDestroyed.fetch_add(1, std::memory_order_relaxed);
+}
+
+void countTextureUpload() {
+    textureUploads.fetch_add(1, std::memory_order_relaxed);
+}
+
+RenderBatch::RenderBatch(SDL_Renderer* renderer) : renderer(renderer), current(nullptr) {
+    textureMarks.texturesCreated = texturesCreated.load(std::memory_order_relaxed);
+    textureMarks.texturesDestroyed = texturesDestroyed.load(std::memory_order_relaxed);
+    textureMarks.textureUploads = textureUploads.load(std::memory_order_relaxed);
+}
+
+void RenderBatch::addSolidSource(SDL_Texture* texture, SDL_FPoint texel) {
+    solidSources.emplace_back(texture, texel);
+}
+
+void RenderBatch::use(SDL_Texture* texture) {
+    if (texture != current) {
+        flush();
+        current = texture;
+    }
+}
+
+void RenderBatch::addSolidQuad(const SDL_Rect& rect, SDL_Color color) {
+    SDL_FPoint texel = {0, 0};
+    bool found = false;
+    for (const auto& [texture, point] : solidSources) {
+        if (texture == current) {
+            texel = point;
+            found = true;
+            break;
+        }
+    }
+    if (!found) {
+        if (solidSources.empty()) {
+            use(nullptr);
+        } else {
+            use(solidSources.front().first);
+            texel = solidSources.front().second;
+        }
+    }
+
+    float x0 = static_cast<float>(rect.x);
+    float y0 = static_cast<float>(rect.y);
+    float x1 = x0 + rect.w;
+    float y1 = y0 + rect.h;
+
+    int base = static_cast<int>(vertices.size());
+    vertices.push_back({{x0, y0}, color, texel});
+    vertices.push_back({{x1, y0}, color, texel});
+    vertices.push_back({{x0, y1}, color, texel});
+    vertices.push_back({{x1, y1}, color, texel});
+    indices.insert(indices.end(), {base, base + 1, base + 2, base + 2, base + 1, base + 3});
+}
+
+void RenderBatch::fillRect(const SDL_Rect& rect, SDL_Color color) {
+    addSolidQuad(rect, color);
+}
+
+void RenderBatch::drawRect(const SDL_Rect& rect, SDL_Color color) {
+    addSolidQuad(SDL_Rect{rect.x, rect.y, rect.w, 1}, color);
+    addSolidQuad(SDL_Rect{rect.x, rect.y + rect.h - 1, rect.w, 1}, color);
+    addSolidQuad(SDL_Rect{rect.x, rect.y + 1, 1, rect.h - 2}, color);
+    addSolidQuad(SDL_Rect{rect.x + rect.w - 1, rect.y + 1, 1, rect.h - 2}, color);
+}
+
+void RenderBatch::addGeometry(SDL_Texture* texture, const std::vector<SDL_Vertex>& newVertices,
+                              const std::vector<int>& newIndices) {
+    if (newIndices.empty()) {
+        return;
+    }
+    use(texture);
+
+    int base = static_cast<int>(vertices.size());
+    vertices.insert(vertices.end(), newVertices.begin(), newVertices.end());
+    for (int index : newIndices) {
+        indices.push_back(base + index);
+    }
+}
+
+void RenderBatch::flush() {
+    if (indices.empty()) {
+        return;
+    }
+    SDL_RenderGeometry(renderer, current, vertices.data(), static_cast<int>(vertices.size()),
+                       indices.data(), static_cast<int>(indices.size()));
+    ++frame.drawCalls;
+    frame.vertices += static_cast<int>(vertices.size());
+    vertices.clear();
+    indices.clear();
+}
+
+void RenderBatch::endFrame() {
+    flush();
+
+    RenderStats marks;
+    marks.texturesCreated = texturesCreated.load(std::memory_order_relaxed);
+    marks.texturesDestroyed = texturesDestroyed.load(std::memory_order_relaxed);
+    marks.textureUploads = textureUploads.load(std::memory_order_relaxed);
+    frame.texturesCreated = marks.texturesCreated - textureMarks.texturesCreated;
+    frame.texturesDestroyed = marks.texturesDestroyed - textureMarks.texturesDestroyed;
+    frame.textureUploads = marks.textureUploads - textureMarks.textureUploads;
+    textureMarks = marks;
+
+    last = frame;
+    frame = RenderStats();
+}
+
+const RenderStats& RenderBatch::lastFrame() const {
+    return last;
+}
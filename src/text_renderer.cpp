@@ -0,0 +1,168 @@
+#include "text_renderer.h"
+#include "render_batch.h"
+#include <stdexcept>
+
+namespace {
+
+const int ATLAS_SIZE = 512;
+const int SOLID_BLOCK = 4; ///< Белый блок в углу атласа для вывода сплошных прямоугольников
+const Uint32 FALLBACK_GLYPH = '?';
+
+Uint32 nextCodepoint(const std::string& text, size_t& i) {
+    unsigned char c = static_cast<unsigned char>(text[i++]);
+    int extra = c >= 0xF0 ? 3 : c >= 0xE0 ? 2 : c >= 0xC0 ? 1 : 0;
+    if (extra == 0 || i + extra > text.size()) {
+        return c;
+    }
+
+    Uint32 codepoint = c & (0x3F >> extra);
+    for (int k = 0; k < extra; ++k) {
+        unsigned char next = static_cast<unsigned char>(text[i + k]);
+        if ((next & 0xC0) != 0x80) {
+            return c;
+        }
+        codepoint = (codepoint << 6) | (next & 0x3F);
+    }
+    i += extra;
+    return codepoint;
+}
+
+}
+
+TextRenderer::TextRenderer(SDL_Renderer* renderer, TTF_Font* font)
+    : renderer(renderer), font(font), atlas(nullptr), height(TTF_FontHeight(font)), penX(SOLID_BLOCK + 1), penY(0) {
+    atlas = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC,
+                              ATLAS_SIZE, ATLAS_SIZE);
+    if (!atlas) {
+        throw std::runtime_error("Failed to create glyph atlas: " + std::string(SDL_GetError()));
+    }
+    countTextureCreated();
+    SDL_SetTextureBlendMode(atlas, SDL_BLENDMODE_BLEND);
+
+    std::vector<Uint32> clear(ATLAS_SIZE * ATLAS_SIZE, 0);
+    SDL_UpdateTexture(atlas, nullptr, clear.data(), ATLAS_SIZE * sizeof(Uint32));
+    countTextureUpload();
+
+    std::vector<Uint32> white(SOLID_BLOCK * SOLID_BLOCK, 0xFFFFFFFF);
+    SDL_Rect solid = {0, 0, SOLID_BLOCK, SOLID_BLOCK};
+    SDL_UpdateTexture(atlas, &solid, white.data(), SOLID_BLOCK * sizeof(Uint32));
+    countTextureUpload();
+
+    for (Uint32 c = ' '; c <= '~'; ++c) {
+        glyph(c);
+    }
+}
+
+TextRenderer::~TextRenderer() {
+    SDL_DestroyTexture(atlas);
+    countTextureDestroyed();
+}
+
+int TextRenderer::lineHeight() const {
+    return height;
+}
+
+SDL_Texture* TextRenderer::texture() const {
+    return atlas;
+}
+
+SDL_FPoint TextRenderer::solidTexel() const {
+    float center = SOLID_BLOCK / 2.0f / ATLAS_SIZE;
+    return SDL_FPoint{center, center};
+}
+
+const TextRenderer::Glyph& TextRenderer::glyph(Uint32 codepoint) {
+    auto it = glyphs.find(codepoint);
+    if (it == glyphs.end()) {
+        it = glyphs.emplace(codepoint, rasterize(codepoint)).first;
+    }
+    return it->second;
+}
+
+TextRenderer::Glyph TextRenderer::rasterize(Uint32 codepoint) {
+    Glyph result = {{0, 0, 0, 0}, 0};
+    if (codepoint > 0xFFFF) {
+        return codepoint == FALLBACK_GLYPH ? result : glyph(FALLBACK_GLYPH);
+    }
+
+    Uint16 ch = static_cast<Uint16>(codepoint);
+    int minx, maxx, miny, maxy;
+    if (TTF_GlyphMetrics(font, ch, &minx, &maxx, &miny, &maxy, &result.advance) != 0) {
+        return codepoint == FALLBACK_GLYPH ? result : glyph(FALLBACK_GLYPH);
+    }
+
+    // Глиф рисуется белым, цвет задается вершинами при выводе
+    SDL_Surface* rendered = TTF_RenderGlyph_Blended(font, ch, SDL_Color{255, 255, 255, 255});
+    if (!rendered) {
+        return result;
+    }
+    SDL_Surface* surface = SDL_ConvertSurfaceFormat(rendered, SDL_PIXELFORMAT_ARGB8888, 0);
+    SDL_FreeSurface(rendered);
+    if (!surface) {
+        return result;
+    }
+
+    if (penX + surface->w > ATLAS_SIZE) {
+        penX = 0;
+        penY += height + 1;
+    }
+    if (surface->w <= ATLAS_SIZE && penY + surface->h <= ATLAS_SIZE) {
+        result.source = {penX, penY, surface->w, surface->h};
+        SDL_UpdateTexture(atlas, &result.source, surface->pixels, surface->pitch);
+        countTextureUpload();
+        penX += surface->w + 1;
+    }
+    // При переполнении атласа глиф выводится как пустой, но сохраняет ширину
+    SDL_FreeSurface(surface);
+    return result;
+}
+
+int TextRenderer::measure(const std::string& text) {
+    int width = 0;
+    for (size_t i = 0; i < text.size();) {
+        width += glyph(nextCodepoint(text, i)).advance;
+    }
+    return width;
+}
+
+void TextRenderer::draw(const std::string& text, int x, int y, SDL_Color color) {
+    vertices.clear();
+    indices.clear();
+    layout(text, x, y, color, vertices, indices);
+    drawGeometry(vertices, indices);
+}
+
+int TextRenderer::layout(const std::string& text, int x, int y, SDL_Color color,
+                         std::vector<SDL_Vertex>& vertices, std::vector<int>& indices) {
+    const float scale = 1.0f / ATLAS_SIZE;
+    int penPos = x;
+    for (size_t i = 0; i < text.size();) {
+        const Glyph& g = glyph(nextCodepoint(text, i));
+        if (g.source.w > 0) {
+            float x0 = static_cast<float>(penPos);
+            float y0 = static_cast<float>(y);
+            float x1 = x0 + g.source.w;
+            float y1 = y0 + g.source.h;
+            float u0 = g.source.x * scale;
+            float v0 = g.source.y * scale;
+            float u1 = (g.source.x + g.source.w) * scale;
+            float v1 = (g.source.y + g.source.h) * scale;
+
+            int base = static_cast<int>(vertices.size());
+            vertices.push_back({{x0, y0}, color, {u0, v0}});
+            vertices.push_back({{x1, y0}, color, {u1, v0}});
+            vertices.push_back({{x0, y1}, color, {u0, v1}});
+            vertices.push_back({{x1, y1}, color, {u1, v1}});
+            indices.insert(indices.end(), {base, base + 1, base + 2, base + 2, base + 1, base + 3});
+        }
+        penPos += g.advance;
+    }
+    return penPos - x;
+}
+
+void TextRenderer::drawGeometry(const std::vector<SDL_Vertex>& vertices, const std::vector<int>& indices) {
+    if (!indices.empty()) {
+        SDL_RenderGeometry(renderer, atlas, vertices.data(), static_cast<int>(vertices.size()),
+                           indices.data(), static_cast<int>(indices.size()));
+    }
+}
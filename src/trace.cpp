@@ -0,0 +1,154 @@
+#include "trace.h"
+
+#ifdef AIP_TRACING
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+/**
+ * @struct TraceEvent
+ * @brief Завершенный участок
+ */
+struct TraceEvent {
+    const char* name;    ///< Имя участка
+    uint64_t startNs;    ///< Начало
+    uint64_t durationNs; ///< Длительность
+};
+
+/**
+ * @struct TraceSlot
+ * @brief Ячейка кольцевого буфера
+ *
+ * Поля атомарны, чтобы writeTraceFile мог читать ячейку, которую поток
+ * в это время перезаписывает; такие ячейки отбрасываются по счетчику started.
+ */
+struct TraceSlot {
+    std::atomic<const char*> name{nullptr}; ///< Имя участка
+    std::atomic<uint64_t> startNs{0};       ///< Начало
+    std::atomic<uint64_t> durationNs{0};    ///< Длительность
+};
+
+/**
+ * @struct TraceBuffer
+ * @brief Кольцевой буфер событий одного потока
+ *
+ * Пишет только поток-владелец. Событие с номером n лежит в ячейке
+ * n % TRACE_BUFFER_EVENTS; started увеличивается до записи ячейки, count -
+ * после, поэтому writeTraceFile без блокировки отличает готовые события от
+ * перезаписываемых.
+ */
+struct TraceBuffer {
+    uint32_t tid = 0;                                         ///< Номер потока в трассе
+    const char* threadName = nullptr;                         ///< Имя потока (под registryMutex)
+    std::atomic<uint64_t> started{0};                         ///< Начатые записи событий
+    std::atomic<uint64_t> count{0};                           ///< Записанные события
+    std::unique_ptr<TraceSlot[]> slots{new TraceSlot[TRACE_BUFFER_EVENTS]}; ///< События
+};
+
+std::mutex registryMutex;
+std::vector<std::unique_ptr<TraceBuffer>> buffers; ///< Буферы всех потоков (живут до выхода)
+
+TraceBuffer& threadBuffer() {
+    thread_local TraceBuffer* buffer = nullptr;
+    if (!buffer) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        buffers.push_back(std::make_unique<TraceBuffer>());
+        buffer = buffers.back().get();
+        buffer->tid = static_cast<uint32_t>(buffers.size());
+    }
+    return *buffer;
+}
+
+}
+
+void traceRecord(const char* name, uint64_t startNs, uint64_t durationNs) {
+    TraceBuffer& buffer = threadBuffer();
+    uint64_t index = buffer.count.load(std::memory_order_relaxed);
+    buffer.started.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    TraceSlot& slot = buffer.slots[index % TRACE_BUFFER_EVENTS];
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.startNs.store(startNs, std::memory_order_relaxed);
+    slot.durationNs.store(durationNs, std::memory_order_relaxed);
+    buffer.count.store(index + 1, std::memory_order_release);
+}
+
+void setTracingEnabled(bool enabled) {
+    tracingActive.store(enabled, std::memory_order_relaxed);
+}
+
+void setTraceThreadName(const char* name) {
+    TraceBuffer& buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(registryMutex);
+    buffer.threadName = name;
+}
+
+void writeTraceFile(const std::string& path) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    std::vector<std::vector<TraceEvent>> events;
+    uint64_t origin = UINT64_MAX;
+    uint64_t dropped = 0;
+    for (const auto& buffer : buffers) {
+        uint64_t count = buffer->count.load(std::memory_order_acquire);
+        uint64_t first = count > TRACE_BUFFER_EVENTS ? count - TRACE_BUFFER_EVENTS : 0;
+        std::vector<TraceEvent> copied;
+        copied.reserve(count - first);
+        for (uint64_t n = first; n < count; ++n) {
+            const TraceSlot& slot = buffer->slots[n % TRACE_BUFFER_EVENTS];
+            copied.push_back({slot.name.load(std::memory_order_relaxed), slot.startNs.load(std::memory_order_relaxed),
+                              slot.durationNs.load(std::memory_order_relaxed)});
+        }
+
+        // Событие n могло быть перезаписано событием n + TRACE_BUFFER_EVENTS, начатым во время копирования
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t started = buffer->started.load(std::memory_order_relaxed);
+        uint64_t valid = started > TRACE_BUFFER_EVENTS ? started - TRACE_BUFFER_EVENTS : 0;
+        if (valid > first) {
+            copied.erase(copied.begin(), copied.begin() + static_cast<ptrdiff_t>(std::min(valid, count) - first));
+            first = std::min(valid, count);
+        }
+        dropped += first;
+
+        for (const TraceEvent& event : copied) {
+            origin = std::min(origin, event.startNs);
+        }
+        events.push_back(std::move(copied));
+    }
+
+    std::ofstream out(path);
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\": \"ms\", \"otherData\": {\"dropped_events\": " << dropped << "},\n"
+        << "\"traceEvents\": [";
+    bool first = true;
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        const TraceBuffer& buffer = *buffers[i];
+        if (buffer.threadName) {
+            out << (first ? "\n" : ",\n") << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": "
+                << buffer.tid << ", \"args\": {\"name\": \"" << buffer.threadName << "\"}}";
+            first = false;
+        }
+        // Время в микросекундах от первого события
+        for (const TraceEvent& event : events[i]) {
+            out << (first ? "\n" : ",\n") << "{\"name\": \"" << event.name << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": "
+                << buffer.tid << ", \"ts\": " << (event.startNs - origin) / 1000.0
+                << ", \"dur\": " << event.durationNs / 1000.0 << "}";
+            first = false;
+        }
+    }
+    out << "\n]}\n";
+    if (!out) {
+        throw std::runtime_error("Failed to write trace to " + path);
+    }
+}
+
+#endif
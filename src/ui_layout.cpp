@@ -0,0 +1,74 @@
+#include "ui_layout.h"
+#include <algorithm>
+#include <utility>
+
+bool UiRect::contains(int px, int py) const {
+    return px >= x && px <= x + w && py >= y && py <= y + h;
+}
+
+ScreenLayout::ScreenLayout(std::vector<Widget> widgets) : items(std::move(widgets)), columns(0), rows(0) {
+    for (const Widget& widget : items) {
+        columns = std::max(columns, (widget.rect.x + widget.rect.w) / CELL_SIZE + 1);
+        rows = std::max(rows, (widget.rect.y + widget.rect.h) / CELL_SIZE + 1);
+    }
+    cells.resize(static_cast<size_t>(columns) * rows);
+
+    for (size_t i = 0; i < items.size(); ++i) {
+        const Widget& widget = items[i];
+        if (widget.kind != WidgetKind::BUTTON) {
+            continue;
+        }
+        // Границы включаются, поэтому правый и нижний край тоже попадают в индекс
+        int left = std::max(widget.rect.x, 0) / CELL_SIZE;
+        int top = std::max(widget.rect.y, 0) / CELL_SIZE;
+        int right = (widget.rect.x + widget.rect.w) / CELL_SIZE;
+        int bottom = (widget.rect.y + widget.rect.h) / CELL_SIZE;
+        for (int row = top; row <= bottom; ++row) {
+            for (int column = left; column <= right; ++column) {
+                cells[static_cast<size_t>(row) * columns + column].push_back(static_cast<uint8_t>(i));
+            }
+        }
+    }
+}
+
+const std::vector<Widget>& ScreenLayout::widgets() const {
+    return items;
+}
+
+const Widget* ScreenLayout::hitTest(int x, int y) const {
+    if (x < 0 || y < 0 || x / CELL_SIZE >= columns || y / CELL_SIZE >= rows) {
+        return nullptr;
+    }
+
+    for (uint8_t index : cells[static_cast<size_t>(y / CELL_SIZE) * columns + x / CELL_SIZE]) {
+        if (items[index].rect.contains(x, y)) {
+            return &items[index];
+        }
+    }
+    return nullptr;
+}
+
+const ScreenLayout& screenLayout(Screen screen) {
+    static const ScreenLayout mainMenu({
+        {WidgetId::CAESAR_BUTTON, WidgetKind::BUTTON, {250, 220, 300, 60}, "Caesar Cipher"},
+        {WidgetId::AFFINE_BUTTON, WidgetKind::BUTTON, {250, 300, 300, 60}, "Affine Cipher"},
+        {WidgetId::VIGENERE_BUTTON, WidgetKind::BUTTON, {250, 380, 300, 60}, "Vigenere Cipher"}
+    });
+    static const ScreenLayout cipher({
+        {WidgetId::INPUT_BOX, WidgetKind::TEXT_BOX, {50, 250, 700, 40}, ""},
+        {WidgetId::MENU_BUTTON, WidgetKind::BUTTON, {100, 450, 200, 60}, "Menu"},
+        {WidgetId::HINT1_BUTTON, WidgetKind::BUTTON, {300, 450, 200, 60}, "Hint 1"},
+        {WidgetId::HINT2_BUTTON, WidgetKind::BUTTON, {500, 450, 200, 60}, "Hint 2"}
+    });
+    static const ScreenLayout result({
+        {WidgetId::SAME_BUTTON, WidgetKind::BUTTON, {200, 400, 200, 60}, "Same Cipher"},
+        {WidgetId::NEW_BUTTON, WidgetKind::BUTTON, {400, 400, 200, 60}, "New Cipher"}
+    });
+
+    switch (screen) {
+        case Screen::MAIN_MENU: return mainMenu;
+        case Screen::CIPHER: return cipher;
+        case Screen::RESULT: return result;
+    }
+    return mainMenu;
+}
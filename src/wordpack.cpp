@@ -0,0 +1,167 @@
+#include "wordpack.h"
+#include "database.h"
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const CipherType PACK_CIPHERS[] = {CipherType::CAESAR, CipherType::AFFINE, CipherType::VIGENERE};
+
+uint64_t alignTo8(uint64_t value) {
+    return (value + 7) & ~uint64_t(7);
+}
+
+}
+
+WordPack::WordPack(const std::string& pack_path) : data(nullptr), size(0), sections{} {
+    int fd = open(pack_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open word pack: " + pack_path);
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(WordPackHeader))) {
+        close(fd);
+        throw std::runtime_error("Invalid word pack: " + pack_path);
+    }
+
+    size = static_cast<size_t>(st.st_size);
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        throw std::runtime_error("Cannot map word pack: " + pack_path);
+    }
+    data = static_cast<const unsigned char*>(mapped);
+
+    // Проверяются только заголовок и границы секций, сами слова не разбираются.
+    // Границы сравниваются без сложения, которое могло бы переполниться
+    const auto* header = reinterpret_cast<const WordPackHeader*>(data);
+    bool valid = std::memcmp(header->magic, WORDPACK_MAGIC, sizeof(WORDPACK_MAGIC)) == 0
+        && header->byteOrder == WORDPACK_BYTE_ORDER
+        && header->version == WORDPACK_VERSION
+        && sizeof(WordPackHeader) + uint64_t(header->sectionCount) * sizeof(WordPackSection) <= size;
+
+    const auto* table = reinterpret_cast<const WordPackSection*>(data + sizeof(WordPackHeader));
+    for (uint32_t i = 0; valid && i < header->sectionCount; ++i) {
+        const WordPackSection& s = table[i];
+        uint64_t offsetsSize = (uint64_t(s.wordCount) + 1) * sizeof(uint32_t);
+        valid = s.cipher < 3
+            && s.offsetsOffset % alignof(uint32_t) == 0
+            && s.offsetsOffset <= size && offsetsSize <= size - s.offsetsOffset
+            && s.lettersOffset <= size && s.lettersSize <= size - s.lettersOffset;
+        if (valid) {
+            const auto* offsets = reinterpret_cast<const uint32_t*>(data + s.offsetsOffset);
+            valid = offsets[s.wordCount] <= s.lettersSize;
+            sections[s.cipher] = &s;
+        }
+    }
+
+    if (!valid) {
+        munmap(const_cast<unsigned char*>(data), size);
+        throw std::runtime_error("Invalid word pack: " + pack_path);
+    }
+}
+
+WordPack::~WordPack() {
+    munmap(const_cast<unsigned char*>(data), size);
+}
+
+void WordPack::build(Database& db, const std::string& pack_path) {
+    std::vector<std::vector<std::string>> words;
+    for (CipherType cipher : PACK_CIPHERS) {
+        words.push_back(db.getAllWords(cipherTableName(cipher)));
+    }
+
+    WordPackHeader header = {};
+    std::memcpy(header.magic, WORDPACK_MAGIC, sizeof(WORDPACK_MAGIC));
+    header.version = WORDPACK_VERSION;
+    header.byteOrder = WORDPACK_BYTE_ORDER;
+    header.sectionCount = static_cast<uint32_t>(words.size());
+
+    std::vector<WordPackSection> table(words.size());
+    std::vector<std::vector<uint32_t>> offsets(words.size());
+    uint64_t position = sizeof(WordPackHeader) + table.size() * sizeof(WordPackSection);
+    for (size_t i = 0; i < words.size(); ++i) {
+        // Смещения хранятся в uint32_t, поэтому сумма считается в 64 битах и проверяется
+        uint64_t letters = 0;
+        offsets[i].push_back(0);
+        for (const auto& word : words[i]) {
+            letters += word.size();
+            if (letters > UINT32_MAX) {
+                throw std::runtime_error("Too many letters for word pack section: " +
+                                         cipherTableName(PACK_CIPHERS[i]));
+            }
+            offsets[i].push_back(static_cast<uint32_t>(letters));
+        }
+
+        WordPackSection& s = table[i];
+        s.cipher = static_cast<uint32_t>(PACK_CIPHERS[i]);
+        s.wordCount = static_cast<uint32_t>(words[i].size());
+        s.offsetsOffset = alignTo8(position);
+        s.lettersOffset = s.offsetsOffset + offsets[i].size() * sizeof(uint32_t);
+        s.lettersSize = offsets[i].back();
+        position = s.lettersOffset + s.lettersSize;
+    }
+
+    std::ofstream out(pack_path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Cannot create word pack: " + pack_path);
+    }
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(WordPackSection));
+    position = sizeof(WordPackHeader) + table.size() * sizeof(WordPackSection);
+    for (size_t i = 0; i < words.size(); ++i) {
+        const char padding[8] = {};
+        out.write(padding, table[i].offsetsOffset - position);
+        out.write(reinterpret_cast<const char*>(offsets[i].data()), offsets[i].size() * sizeof(uint32_t));
+        for (const auto& word : words[i]) {
+            out.write(word.data(), word.size());
+        }
+        position = table[i].lettersOffset + table[i].lettersSize;
+    }
+
+    if (!out) {
+        throw std::runtime_error("Failed to write word pack: " + pack_path);
+    }
+}
+
+const WordPackSection* WordPack::section(CipherType cipher) const {
+    return sections[static_cast<size_t>(cipher)];
+}
+
+size_t WordPack::wordCount(CipherType cipher) const {
+    const WordPackSection* s = section(cipher);
+    return s ? s->wordCount : 0;
+}
+
+std::string_view WordPack::word(CipherType cipher, size_t index) const {
+    const WordPackSection* s = section(cipher);
+    if (!s || index >= s->wordCount) {
+        throw std::out_of_range("Word index out of range");
+    }
+
+    const auto* offsets = reinterpret_cast<const uint32_t*>(data + s->offsetsOffset);
+    uint32_t begin = offsets[index];
+    uint32_t end = offsets[index + 1];
+    if (begin > end || end > s->lettersSize) {
+        throw std::out_of_range("Corrupted word offsets");
+    }
+
+    const char* letters = reinterpret_cast<const char*>(data + s->lettersOffset);
+    return std::string_view(letters + begin, end - begin);
+}
+
+std::string_view WordPack::randomWord(CipherType cipher) const {
+    size_t count = wordCount(cipher);
+    if (count == 0) {
+        throw std::runtime_error("No words found in word pack");
+    }
+    return word(cipher, static_cast<size_t>(randNum(0, static_cast<int>(count) - 1)));
+}
@@ -56,4 +56,8 @@ TEST_CASE("Test common") {
     int num = randNum(5, 10);
     CHECK(num >= 5);
     CHECK(num <= 10);
+
+    // Байты UTF-8 (кириллическая "е") не считаются буквами и проходят шифр без изменений
+    CHECK(puzzleDifficulty("\xd0\xb5hesunshinesbright") == 2);
+    CHECK(caesarEncrypt("\xd0\xb5" "a", 1) == "\xd0\xb5" "b");
 }
\ No newline at end of file
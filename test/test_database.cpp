@@ -0,0 +1,234 @@
+#include <doctest.h>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "../include/async_database.h"
+#include "../include/ciphers.h"
+#include "../include/database.h"
+#include "../include/metrics.h"
+#include "../include/wordpack.h"
+
+static const char* TEST_DB = "test_database.db";
+
+TEST_CASE("Test Database in-memory") {
+    std::remove(TEST_DB);
+
+    SUBCASE("Missing file") {
+        CHECK_THROWS(Database::loadImage(TEST_DB));
+        CHECK(!std::ifstream(TEST_DB));
+    }
+
+    { Database disk(TEST_DB); }
+
+    SUBCASE("Read from image") {
+        Database db(TEST_DB, DatabaseMode::IN_MEMORY);
+        CHECK(!db.getRandomWord("caesar_cipher").empty());
+        CHECK(!db.getRandomWord("affine_cipher").empty());
+        CHECK(!db.getRandomWord("vigenere_cipher").empty());
+        CHECK_THROWS(db.getRandomWord("missing_table"));
+
+        std::mt19937 first(7), second(7);
+        for (int i = 0; i < 10; ++i) {
+            CHECK(db.getRandomWord("caesar_cipher", first) == db.getRandomWord("caesar_cipher", second));
+        }
+    }
+
+    SUBCASE("Shared image") {
+        auto image = Database::loadImage(TEST_DB);
+        Database first(image);
+        Database second(image);
+        CHECK(!first.getRandomWord("caesar_cipher").empty());
+        CHECK(!second.getRandomWord("caesar_cipher").empty());
+    }
+
+    SUBCASE("Invalid image") {
+        CHECK_THROWS(Database(std::make_shared<DatabaseImage>()));
+    }
+
+    std::remove(TEST_DB);
+}
+
+TEST_CASE("Test WordPack") {
+    std::remove(TEST_DB);
+    const char* packPath = "test_words.pack";
+
+    {
+        Database db(TEST_DB);
+        WordPack::build(db, packPath);
+
+        WordPack pack(packPath);
+        for (CipherType cipher : {CipherType::CAESAR, CipherType::AFFINE, CipherType::VIGENERE}) {
+            auto words = db.getAllWords(cipherTableName(cipher));
+            REQUIRE(pack.wordCount(cipher) == words.size());
+            for (size_t i = 0; i < words.size(); ++i) {
+                CHECK(pack.word(cipher, i) == words[i]);
+            }
+            CHECK(!pack.randomWord(cipher).empty());
+        }
+        CHECK_THROWS(pack.word(CipherType::CAESAR, pack.wordCount(CipherType::CAESAR)));
+    }
+
+    SUBCASE("Invalid file") {
+        CHECK_THROWS(WordPack(TEST_DB));
+        CHECK_THROWS(WordPack("missing.pack"));
+    }
+
+    SUBCASE("Corrupted section") {
+        std::fstream file(packPath, std::ios::in | std::ios::out | std::ios::binary);
+        WordPackSection s;
+        file.seekg(sizeof(WordPackHeader));
+        file.read(reinterpret_cast<char*>(&s), sizeof(s));
+
+        // lettersOffset + lettersSize переполняется и становится меньше размера файла
+        s.lettersSize = UINT64_MAX - s.lettersOffset + 2;
+        file.seekp(sizeof(WordPackHeader));
+        file.write(reinterpret_cast<const char*>(&s), sizeof(s));
+        file.close();
+        CHECK_THROWS(WordPack(packPath));
+    }
+
+    SUBCASE("Other byte order") {
+        std::fstream file(packPath, std::ios::in | std::ios::out | std::ios::binary);
+        WordPackHeader header;
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        header.byteOrder = 0x04030201;
+        file.seekp(0);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.close();
+        CHECK_THROWS(WordPack(packPath));
+    }
+
+    std::remove(packPath);
+    std::remove(TEST_DB);
+}
+
+TEST_CASE("Test cipher SQL functions") {
+    std::remove(TEST_DB);
+
+    {
+        Database db(TEST_DB);
+        db.execute("CREATE TABLE generated (id INTEGER PRIMARY KEY, word TEXT);");
+
+        db.execute("INSERT INTO generated (word) SELECT caesar('abc', 1);");
+        CHECK(db.getRandomWord("generated") == caesarEncrypt("abc", 1));
+
+        db.execute("DELETE FROM generated;"
+                   "INSERT INTO generated (word) SELECT affine('abc', 5, 8);");
+        CHECK(db.getRandomWord("generated") == affineEncrypt("abc", 5, 8));
+
+        db.execute("DELETE FROM generated;"
+                   "INSERT INTO generated (word) SELECT vigenere('attackatdawn', 'lemon');");
+        CHECK(db.getRandomWord("generated") == "lxfopvefrnhr");
+
+        db.execute("DELETE FROM generated;"
+                   "INSERT INTO generated (word) SELECT caesar(word, 3) FROM caesar_cipher;");
+        CHECK(db.getAllWords("generated").size() == db.getAllWords("caesar_cipher").size());
+
+        // Слово после пропуска в rowid выбирается не чаще остальных
+        db.execute("DELETE FROM generated;"
+                   "INSERT INTO generated (id, word) VALUES (1, 'a'), (6, 'b'), (7, 'c'), (8, 'd'), (9, 'e'), (10, 'f');");
+        std::mt19937 rng(1);
+        int afterGap = 0;
+        for (int i = 0; i < 600; ++i) {
+            afterGap += db.getRandomWord("generated", rng) == "b";
+        }
+        CHECK(afterGap < 200);
+
+        CHECK_THROWS(db.execute("SELECT affine('abc', 2, 0);"));
+        CHECK_THROWS(db.execute("SELECT vigenere('abc', '');"));
+    }
+
+    std::remove(TEST_DB);
+}
+
+TEST_CASE("Test precomputed puzzles") {
+    std::remove(TEST_DB);
+
+    {
+        Database db(TEST_DB);
+        CHECK(!db.hasPuzzles(CipherType::CAESAR));
+        CHECK_THROWS(db.getRandomPuzzle(CipherType::CAESAR));
+
+        db.buildPuzzles();
+        for (int i = 0; i < 50; ++i) {
+            Puzzle caesar = db.getRandomPuzzle(CipherType::CAESAR);
+            CHECK(caesar.cipher == CipherType::CAESAR);
+            CHECK(caesar.ciphertext == caesarEncrypt(caesar.plaintext, std::stoi(caesar.key)));
+            CHECK(caesar.difficulty == puzzleDifficulty(caesar.plaintext));
+
+            Puzzle vigenere = db.getRandomPuzzle(CipherType::VIGENERE);
+            CHECK(vigenere.ciphertext == vigenereEncrypt(vigenere.plaintext, vigenere.key));
+        }
+
+        Puzzle affine = db.getRandomPuzzle(CipherType::AFFINE);
+        int a = std::stoi(affine.key);
+        int b = std::stoi(affine.key.substr(affine.key.find(',') + 1));
+        CHECK(affine.ciphertext == affineEncrypt(affine.plaintext, a, b));
+    }
+
+    SUBCASE("Shared by in-memory image") {
+        Database db(TEST_DB, DatabaseMode::IN_MEMORY);
+        CHECK(db.hasPuzzles(CipherType::AFFINE));
+        CHECK(!db.getRandomPuzzle(CipherType::AFFINE).ciphertext.empty());
+    }
+
+    std::remove(TEST_DB);
+}
+
+TEST_CASE("Test AsyncDatabase") {
+    std::remove(TEST_DB);
+
+    {
+        AsyncDatabase db(TEST_DB);
+        std::vector<std::future<std::string>> words;
+        for (int i = 0; i < 20; ++i) {
+            words.push_back(db.getRandomWordAsync("caesar_cipher"));
+        }
+        for (auto& word : words) {
+            CHECK(!word.get().empty());
+        }
+
+        CHECK_THROWS(db.getRandomWordAsync("missing_table").get());
+        CHECK_THROWS(db.getRandomPuzzleAsync(CipherType::CAESAR).get());
+
+        db.executeAsync("CREATE TABLE generated (id INTEGER PRIMARY KEY, word TEXT);"
+                        "INSERT INTO generated (word) SELECT caesar('abc', 1);").get();
+        auto count = db.submit([](Database& d) { return d.getAllWords("generated").size(); });
+        CHECK(count.get() == 1);
+    }
+
+    SUBCASE("Open failure") {
+        CHECK_THROWS(AsyncDatabase("missing_dir/none.db"));
+    }
+
+    std::remove(TEST_DB);
+}
+
+TEST_CASE("Test query profiling") {
+    std::remove(TEST_DB);
+    {
+        Database db(TEST_DB);
+        db.execute("CREATE TABLE numbers (n INTEGER); INSERT INTO numbers VALUES (1), (2), (3);");
+        db.execute("SELECT * FROM numbers WHERE n > 0 ORDER BY n;");
+        db.execute("SELECT * FROM numbers WHERE n > 1 ORDER BY n;");
+        for (int i = 0; i < 10; ++i) {
+            db.getRandomWord("caesar_cipher");
+        }
+    }
+
+    // Литералы заменены на ?, поэтому оба запроса попадают в одну метрику
+    std::string text = metrics().toPrometheus();
+    const std::string labels = "{sql=\"SELECT * FROM numbers WHERE n > ? ORDER BY n;\"}";
+    CHECK(text.find("aip_sql_seconds_count" + labels + " 2\n") != std::string::npos);
+    CHECK(text.find("aip_sql_rows_total" + labels + " 5\n") != std::string::npos);
+    CHECK(text.find("aip_sql_sorts_total" + labels + " 2\n") != std::string::npos);
+    CHECK(text.find("aip_sql_fullscan_steps_total" + labels) != std::string::npos);
+    CHECK(text.find("aip_sql_fullscan_steps_total" + labels + " 0\n") == std::string::npos);
+
+    // Случайное слово выбирается поиском по ключу, без просмотра таблицы
+    const std::string wordLabels = "{sql=\"SELECT rowid, word FROM caesar_cipher WHERE rowid >= ? ORDER BY rowid LIMIT ?;\"}";
+    CHECK(text.find("aip_sql_fullscan_steps_total" + wordLabels + " 0\n") != std::string::npos);
+    std::remove(TEST_DB);
+}
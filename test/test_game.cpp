@@ -0,0 +1,442 @@
+#include <doctest.h>
+#include "../include/ciphers.h"
+#include "../include/frame_stats.h"
+#include "../include/game_core.h"
+#include "../include/input_record.h"
+#include "../include/latency_tracker.h"
+#include "../include/memory_tracking.h"
+#include "../include/metrics.h"
+#include "../include/puzzle_prefetcher.h"
+#include "../include/trace.h"
+#include "../include/triple_buffer.h"
+#include "../include/ui_layout.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+static const Widget* hit(Screen screen, int x, int y) {
+    return screenLayout(screen).hitTest(x, y);
+}
+
+TEST_CASE("Test UI layout") {
+    SUBCASE("Main menu") {
+        REQUIRE(hit(Screen::MAIN_MENU, 400, 250));
+        CHECK(hit(Screen::MAIN_MENU, 400, 250)->id == WidgetId::CAESAR_BUTTON);
+        CHECK(hit(Screen::MAIN_MENU, 250, 300)->id == WidgetId::AFFINE_BUTTON);
+        CHECK(hit(Screen::MAIN_MENU, 550, 440)->id == WidgetId::VIGENERE_BUTTON);
+        CHECK(hit(Screen::MAIN_MENU, 400, 290) == nullptr);
+        CHECK(hit(Screen::MAIN_MENU, 249, 250) == nullptr);
+    }
+
+    SUBCASE("Cipher screen") {
+        CHECK(hit(Screen::CIPHER, 150, 480)->id == WidgetId::MENU_BUTTON);
+        CHECK(hit(Screen::CIPHER, 300, 480)->id == WidgetId::MENU_BUTTON);
+        CHECK(hit(Screen::CIPHER, 301, 480)->id == WidgetId::HINT1_BUTTON);
+        CHECK(hit(Screen::CIPHER, 700, 510)->id == WidgetId::HINT2_BUTTON);
+        CHECK(hit(Screen::CIPHER, 400, 270) == nullptr);
+    }
+
+    SUBCASE("Result screen") {
+        CHECK(hit(Screen::RESULT, 300, 430)->id == WidgetId::SAME_BUTTON);
+        CHECK(hit(Screen::RESULT, 500, 430)->id == WidgetId::NEW_BUTTON);
+    }
+
+    SUBCASE("Outside") {
+        CHECK(hit(Screen::CIPHER, -5, 480) == nullptr);
+        CHECK(hit(Screen::CIPHER, 5000, 5000) == nullptr);
+    }
+}
+
+static Puzzle fakePuzzle(CipherType cipher) {
+    Puzzle puzzle;
+    puzzle.cipher = cipher;
+    puzzle.plaintext = "hello";
+    puzzle.key = "3";
+    puzzle.ciphertext = caesarEncrypt(puzzle.plaintext, 3);
+    puzzle.difficulty = puzzleDifficulty(puzzle.plaintext);
+    return puzzle;
+}
+
+TEST_CASE("Test GameCore") {
+    GameCore core(fakePuzzle);
+    CHECK(core.state().screen() == Screen::MAIN_MENU);
+
+    SUBCASE("Round") {
+        CHECK(core.click(400, 330));
+        CHECK(core.state().screen() == Screen::CIPHER);
+        CHECK(core.state().currentCipher == CipherType::AFFINE);
+        CHECK(core.state().encryptedWord == "khoor");
+
+        core.typeText("helo");
+        core.backspace();
+        core.checkAnswer();
+        CHECK(!core.state().gameWon);
+
+        core.typeText("lo");
+        core.backspace();
+        core.typeText("o");
+        uint64_t before = core.revision();
+        core.checkAnswer();
+        CHECK(core.state().gameWon);
+        CHECK(core.revision() > before);
+        CHECK(core.state().screen() == Screen::RESULT);
+
+        core.typeText("ignored");
+        CHECK(core.state().userInput == "hello");
+    }
+
+    SUBCASE("Hints and menu") {
+        core.pressWidget(WidgetId::VIGENERE_BUTTON);
+        core.click(400, 480);
+        core.click(600, 480);
+        CHECK(core.state().showHint1);
+        CHECK(core.state().showHint2);
+
+        core.click(150, 480);
+        CHECK(core.state().screen() == Screen::MAIN_MENU);
+        CHECK(!core.state().showHint1);
+        CHECK(core.state().cipherKey.empty());
+    }
+
+    SUBCASE("Many rounds") {
+        const CipherType ciphers[] = {CipherType::CAESAR, CipherType::AFFINE, CipherType::VIGENERE};
+        int won = 0;
+        for (int round = 0; round < 3000; ++round) {
+            core.showCipherScreen(ciphers[round % 3]);
+            core.typeText(core.state().decryptedWord);
+            core.checkAnswer();
+            won += core.state().gameWon ? 1 : 0;
+            core.pressWidget(round % 2 ? WidgetId::SAME_BUTTON : WidgetId::NEW_BUTTON);
+        }
+        CHECK(won == 3000);
+    }
+
+    SUBCASE("Round arena") {
+        core.showCipherScreen(CipherType::CAESAR);
+        // Ввод длиннее встроенного буфера арены продолжается в куче
+        core.typeText(std::string(3000, 'x'));
+        CHECK(core.state().userInput.size() == 3000);
+
+        GameState copy = core.state();
+        CHECK(copy.userInput.get_allocator().resource() == std::pmr::get_default_resource());
+        core.showCipherScreen(CipherType::CAESAR);
+        CHECK(core.state().userInput.empty());
+        CHECK(core.state().encryptedWord == "khoor");
+        CHECK(copy.userInput.size() == 3000);
+    }
+}
+
+TEST_CASE("Test TripleBuffer") {
+    TripleBuffer<std::pair<int, int>> buffer;
+    CHECK(!buffer.update());
+
+    buffer.back() = {1, 1};
+    buffer.publish();
+    buffer.back() = {2, 2};
+    buffer.publish();
+    CHECK(buffer.update());
+    CHECK(buffer.front().first == 2);
+    CHECK(!buffer.update());
+
+    // Читатель никогда не видит наполовину записанный снимок
+    const int count = 100000;
+    std::thread writer([&buffer] {
+        for (int i = 1; i <= count; ++i) {
+            buffer.back() = {i, -i};
+            buffer.publish();
+        }
+    });
+    int last = 0;
+    bool consistent = true;
+    while (last < count) {
+        if (buffer.update()) {
+            consistent = consistent && buffer.front().first == -buffer.front().second
+                                    && buffer.front().first > last;
+            last = buffer.front().first;
+        }
+    }
+    writer.join();
+    CHECK(consistent);
+}
+
+TEST_CASE("Test PuzzlePrefetcher") {
+    SUBCASE("Bounded queues") {
+        std::atomic<int> generated{0};
+        {
+            PuzzlePrefetcher prefetcher([&generated](CipherType type) {
+                ++generated;
+                return fakePuzzle(type);
+            }, 2);
+
+            GameCore core([&prefetcher](CipherType type) { return prefetcher.next(type); });
+            for (int round = 0; round < 100; ++round) {
+                core.pressWidget(WidgetId::VIGENERE_BUTTON);
+                CHECK(core.state().encryptedWord == "khoor");
+                core.pressWidget(WidgetId::MENU_BUTTON);
+            }
+        }
+        // 100 головоломок отдано, не больше двух ждут в каждой очереди
+        CHECK(generated >= 100);
+        CHECK(generated <= 100 + 3*2);
+    }
+
+    SUBCASE("Deterministic after seedRandom") {
+        auto play = [](bool slowConsumer) {
+            seedRandom(42);
+            PuzzlePrefetcher prefetcher([](CipherType type) {
+                Puzzle puzzle = fakePuzzle(type);
+                puzzle.key = std::to_string(randNum(0, 1000000));
+                return puzzle;
+            }, 2);
+
+            const CipherType order[] = {CipherType::AFFINE, CipherType::AFFINE, CipherType::AFFINE,
+                                        CipherType::CAESAR, CipherType::VIGENERE, CipherType::AFFINE};
+            std::string keys;
+            for (CipherType type : order) {
+                if (slowConsumer) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                }
+                keys += prefetcher.next(type).key + " ";
+            }
+            return keys;
+        };
+        CHECK(play(false) == play(true));
+    }
+
+    SUBCASE("Source failure") {
+        PuzzlePrefetcher prefetcher([](CipherType) -> Puzzle {
+            throw std::runtime_error("no words");
+        });
+        CHECK_THROWS_AS(prefetcher.next(CipherType::CAESAR), std::runtime_error);
+    }
+}
+
+TEST_CASE("Test FrameStats") {
+    FrameStats stats(100);
+    CHECK(stats.summary().frames == 0);
+
+    // 150 кадров, в окне остаются последние 100 со временем 51..150 мс
+    for (int i = 1; i <= 150; ++i) {
+        FrameSample sample;
+        sample.frameMs = i;
+        sample.intervalMs = 2 * i;
+        sample.stageMs[static_cast<size_t>(FrameStage::RENDER)] = 2;
+        sample.drawCalls = 3;
+        sample.texturesCreated = i == 150 ? 1 : 0;
+        stats.addFrame(sample);
+    }
+
+    FrameSummary summary = stats.summary();
+    CHECK(summary.frames == 100);
+    CHECK(summary.maxMs == 150);
+    CHECK(summary.p50Ms == doctest::Approx(100).epsilon(0.02));
+    CHECK(summary.p99Ms == doctest::Approx(149).epsilon(0.01));
+    CHECK(summary.fps == doctest::Approx(1000.0 / 201));
+    CHECK(summary.stageMs[static_cast<size_t>(FrameStage::RENDER)] == doctest::Approx(2));
+    CHECK(summary.drawCalls == doctest::Approx(3));
+    CHECK(summary.texturesCreated == doctest::Approx(0.01));
+
+    std::string json = stats.toJson();
+    CHECK(json.find("\"frames\": 100") != std::string::npos);
+    CHECK(json.find("\"render\": 2") != std::string::npos);
+    CHECK(stats.overlayLines().size() == 4);
+}
+
+TEST_CASE("Test LatencyTracker") {
+    using namespace std::chrono;
+    LatencyTracker tracker;
+    LatencyTracker::Clock::time_point t0 = LatencyTracker::Clock::now();
+
+    tracker.inputApplied(1, t0);
+    tracker.inputApplied(2, t0 + milliseconds(5));
+    tracker.inputApplied(3, t0 + milliseconds(10));
+
+    // Кадр со старой версией не показывает ни одного события
+    tracker.framePresented(0, t0 + milliseconds(12));
+    CHECK(tracker.summary().count == 0);
+
+    // Кадр версии 2 показывает первые два события: 20 и 15 мс
+    tracker.framePresented(2, t0 + milliseconds(20));
+    tracker.framePresented(3, t0 + milliseconds(110));
+
+    LatencySummary summary = tracker.summary();
+    CHECK(summary.count == 3);
+    CHECK(summary.maxMs == doctest::Approx(100));
+    CHECK(summary.meanMs == doctest::Approx(45));
+    CHECK(summary.p50Ms == 20);
+    CHECK(summary.p99Ms == 100);
+    CHECK(tracker.toJson().find("\"count\": 3") != std::string::npos);
+}
+
+TEST_CASE("Test input recording") {
+    const char* path = "test_input_record.bin";
+    {
+        InputRecorder recorder(path, 1234);
+        RecordedEvent click;
+        click.timeMs = 10;
+        click.type = RecordedEventType::MOUSE_DOWN;
+        click.x = 400;
+        click.y = 250;
+        recorder.record(click);
+
+        RecordedEvent text;
+        text.timeMs = 250;
+        text.type = RecordedEventType::TEXT_INPUT;
+        text.text = "hé";
+        recorder.record(text);
+
+        RecordedEvent key;
+        key.timeMs = 300;
+        key.type = RecordedEventType::KEY_DOWN;
+        key.code = 13;
+        recorder.record(key);
+    }
+
+    InputRecording recording = InputRecording::load(path);
+    CHECK(recording.seed == 1234);
+    REQUIRE(recording.events.size() == 3);
+    CHECK(recording.events[0].type == RecordedEventType::MOUSE_DOWN);
+    CHECK(recording.events[0].x == 400);
+    CHECK(recording.events[0].y == 250);
+    CHECK(recording.events[1].text == "hé");
+    CHECK(recording.events[1].timeMs == 250);
+    CHECK(recording.events[2].code == 13);
+
+    // Обрезанный файл не загружается
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        // Числа лежат в little-endian на любой машине: seed 1234 = 0x04d2
+        CHECK(data.substr(8, 4) == std::string("\xd2\x04\x00\x00", 4));
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(data.data(), data.size() - 2);
+    }
+    CHECK_THROWS(InputRecording::load(path));
+    std::remove(path);
+}
+
+TEST_CASE("Test metrics") {
+    MetricsRegistry registry;
+    Counter& counter = registry.counter("test_events_total", "Test events");
+    CHECK(&registry.counter("test_events_total", "Test events") == &counter);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&counter] {
+            for (int i = 0; i < 1000; ++i) {
+                counter.add();
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    CHECK(counter.value() == 4000);
+
+    Histogram& histogram = registry.histogram("test_seconds", "Test durations", {0.01, 0.1});
+    histogram.observe(0.005);
+    histogram.observe(0.01);
+    histogram.observe(0.05);
+    histogram.observe(2.0);
+    HistogramSnapshot snapshot = histogram.snapshot();
+    CHECK(snapshot.counts == std::vector<uint64_t>{2, 1, 1});
+    CHECK(snapshot.count == 4);
+    CHECK(snapshot.sum == doctest::Approx(2.065));
+
+    std::string text = registry.toPrometheus();
+    CHECK(text.find("# TYPE test_events_total counter\ntest_events_total 4000\n") != std::string::npos);
+    CHECK(text.find("test_seconds_bucket{le=\"0.1\"} 3\n") != std::string::npos);
+    CHECK(text.find("test_seconds_bucket{le=\"+Inf\"} 4\n") != std::string::npos);
+
+    const char* path = "test_metrics.json";
+    {
+        MetricsWriter writer(registry, path, std::chrono::seconds(60));
+    }
+    std::ifstream in(path);
+    std::string json((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    CHECK(json.find("\"test_events_total\": 4000") != std::string::npos);
+    std::remove(path);
+}
+
+#ifdef AIP_MEMORY_TRACKING
+TEST_CASE("Test memory tracking") {
+    MemoryUsage before = memoryUsage(MemorySubsystem::CIPHER);
+    std::string encrypted = caesarEncrypt(std::string(1000, 'a'), 3);
+    MemoryUsage after = memoryUsage(MemorySubsystem::CIPHER);
+    CHECK(after.allocations > before.allocations);
+    CHECK(after.allocatedBytes >= before.allocatedBytes + 1000);
+
+    // Освобождение уменьшает счетчик подсистемы, выделившей блок, а не текущей
+    MemoryUsage state = memoryUsage(MemorySubsystem::GAME_STATE);
+    {
+        AIP_MEMORY_SCOPE(GAME_STATE);
+        std::string().swap(encrypted);
+    }
+    CHECK(memoryUsage(MemorySubsystem::GAME_STATE).currentBytes == state.currentBytes);
+    CHECK(memoryUsage(MemorySubsystem::CIPHER).currentBytes <= after.currentBytes - 1000);
+    CHECK(memoryUsage(MemorySubsystem::CIPHER).peakBytes >= after.currentBytes);
+
+    void* block = trackedRealloc(trackedCalloc(4, 8), 64);
+    CHECK(block != nullptr);
+    trackedFree(block);
+    CHECK(memoryUsageJson().find("\"game_state\": {") != std::string::npos);
+
+    // Ввод внутри раунда пишет в арену раунда, а не в кучу
+    GameCore core(fakePuzzle);
+    core.showCipherScreen(CipherType::CAESAR);
+    MemoryUsage round = memoryUsage(MemorySubsystem::GAME_STATE);
+    for (int i = 0; i < 100; ++i) {
+        core.typeText("abc");
+        core.backspace();
+    }
+    CHECK(memoryUsage(MemorySubsystem::GAME_STATE).allocations == round.allocations);
+}
+#endif
+
+#ifdef AIP_TRACING
+TEST_CASE("Test trace") {
+    const char* path = "test_trace.json";
+    setTracingEnabled(true);
+    caesarEncrypt("hello", 3);
+    std::thread worker([] {
+        setTraceThreadName("worker");
+        AIP_TRACE_SCOPE("worker scope");
+    });
+    worker.join();
+    setTracingEnabled(false);
+    caesarEncrypt("ignored", 3);
+    writeTraceFile(path);
+
+    std::ifstream in(path);
+    std::string json((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    CHECK(json.find("\"name\": \"caesarEncrypt\", \"ph\": \"X\"") != std::string::npos);
+    CHECK(json.find("\"name\": \"worker scope\"") != std::string::npos);
+    CHECK(json.find("\"args\": {\"name\": \"worker\"}") != std::string::npos);
+    std::remove(path);
+}
+
+TEST_CASE("Test trace keeps newest events") {
+    const char* path = "test_trace_ring.json";
+    setTracingEnabled(true);
+    for (size_t i = 0; i < TRACE_BUFFER_EVENTS + 100; ++i) {
+        AIP_TRACE_SCOPE(i < TRACE_BUFFER_EVENTS ? "old scope" : "new scope");
+    }
+    setTracingEnabled(false);
+    writeTraceFile(path);
+
+    std::ifstream in(path);
+    std::string json((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    size_t newest = 0;
+    for (size_t at = json.find("\"new scope\""); at != std::string::npos; at = json.find("\"new scope\"", at + 1)) {
+        ++newest;
+    }
+    CHECK(newest == 100);
+    CHECK(json.find("\"dropped_events\": 0,") == std::string::npos);
+    std::remove(path);
+}
+#endif